@@ -0,0 +1,213 @@
+#include "ndnmps/bls-helpers.hpp"
+#include <benchmark/benchmark.h>
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+static const std::string MESSAGE = "/ndn/mps/benchmark/message";
+
+/**
+ * Key pairs and signatures over MESSAGE, generated once and shared by all cases.
+ */
+struct KeySet
+{
+  std::vector<BLSSecretKey> m_sks;
+  std::vector<BLSPublicKey> m_pks;
+  std::vector<BLSSignature> m_sigs;
+};
+
+static const KeySet&
+getKeySet(size_t size)
+{
+  static KeySet keySet;
+  ndnBLSInit();
+  while (keySet.m_sks.size() < size) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    BLSSignature sig;
+    blsSign(&sig, &sk, MESSAGE.data(), MESSAGE.size());
+    keySet.m_sks.push_back(sk);
+    keySet.m_pks.push_back(pk);
+    keySet.m_sigs.push_back(sig);
+  }
+  return keySet;
+}
+
+static Data
+makeData(size_t payloadSize, const std::string& name = "/a/b/c")
+{
+  Data data(name);
+  Buffer content(payloadSize);
+  random::generateSecureBytes(content.data(), content.size());
+  data.setContent(content.data(), content.size());
+  return data;
+}
+
+static const SignatureInfo SIG_INFO(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                                    KeyLocator(Name("/signer/KEY/123")));
+
+// signature piece of one signer; run with multiple threads to see how signing scales on one host
+static void
+BM_GenSignature(benchmark::State& state)
+{
+  const auto& sk = getKeySet(1).m_sks[0];
+  auto data = makeData(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnGenBLSSignature(sk, data, SIG_INFO));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenSignature)->RangeMultiplier(8)->Range(16, 8192)->ThreadRange(1, 8)->UseRealTime();
+
+// signing the same packet again, as for a retried request; range(1) keys share each packet, as signers of one process
+static void
+BM_GenSignatureCached(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(1));
+  auto data = makeData(state.range(0));
+  ndnBLSSetSignatureCacheCapacity(64);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnGenBLSSignature(keySet.m_sks[i++ % state.range(1)], data, SIG_INFO));
+  }
+  ndnBLSSetSignatureCacheCapacity(0);
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenSignatureCached)->Ranges({{16, 8192}, {1, 1}})->Args({8192, 8});
+
+static void
+BM_Verify(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(1);
+  auto data = makeData(state.range(0));
+  ndnBLSSign(keySet.m_sks[0], data, SIG_INFO);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSVerify(keySet.m_pks[0], data));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Verify)->RangeMultiplier(8)->Range(16, 8192)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+BM_AggregateSignature(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  std::vector<BLSSignature> sigs(keySet.m_sigs.begin(), keySet.m_sigs.begin() + state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSAggregateSignature(sigs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregateSignature)->RangeMultiplier(4)->Range(1, 4096);
+
+static void
+BM_AggregateSerializedSignature(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  std::vector<Buffer> sigs;
+  uint8_t buf[128];
+  for (int64_t i = 0; i < state.range(0); i++) {
+    auto size = blsSignatureSerialize(buf, sizeof(buf), &keySet.m_sigs[i]);
+    sigs.emplace_back(buf, size);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSAggregateSignature(sigs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregateSerializedSignature)->RangeMultiplier(4)->Range(1, 4096);
+
+static void
+BM_AggregatePublicKey(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  std::vector<BLSPublicKey> pks(keySet.m_pks.begin(), keySet.m_pks.begin() + state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSAggregatePublicKey(pks));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregatePublicKey)->RangeMultiplier(4)->Range(1, 4096);
+
+// the sequential blsPublicKeyAdd loop, as the baseline of BM_AggregatePublicKey
+static void
+BM_AggregatePublicKeySequential(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  for (auto _ : state) {
+    BLSPublicKey aggKey = keySet.m_pks[0];
+    for (int64_t i = 1; i < state.range(0); i++) {
+      blsPublicKeyAdd(&aggKey, &keySet.m_pks[i]);
+    }
+    benchmark::DoNotOptimize(aggKey);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregatePublicKeySequential)->RangeMultiplier(4)->Range(1, 4096);
+
+static void
+BM_BatchVerifySameMessage(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  std::vector<BLSPublicKey> pks(keySet.m_pks.begin(), keySet.m_pks.begin() + state.range(0));
+  std::vector<BLSSignature> sigs(keySet.m_sigs.begin(), keySet.m_sigs.begin() + state.range(0));
+  Buffer message(MESSAGE.data(), MESSAGE.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSBatchVerifySameMessage(pks, sigs, message));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BatchVerifySameMessage)->RangeMultiplier(4)->Range(1, 1024);
+
+static void
+BM_AggregateVerify(benchmark::State& state)
+{
+  const auto& keySet = getKeySet(state.range(0));
+  std::vector<Data> packets;
+  std::vector<BLSSignature> sigs;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    auto data = makeData(1024, "/a/b/" + std::to_string(i));
+    ndnBLSSign(keySet.m_sks[i], data, SIG_INFO);
+    BLSSignature sig;
+    blsSignatureDeserialize(&sig, data.getSignatureValue().value(), data.getSignatureValue().value_size());
+    packets.push_back(data);
+    sigs.push_back(sig);
+  }
+  std::vector<BLSPublicKey> pks(keySet.m_pks.begin(), keySet.m_pks.begin() + state.range(0));
+  auto aggSig = ndnBLSAggregateSignature(sigs);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSAggregateVerify(pks, packets, aggSig));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AggregateVerify)->RangeMultiplier(4)->Range(1, 256);
+
+static void
+BM_RecoverThresholdSignature(benchmark::State& state)
+{
+  ndnBLSInit();
+  auto threshold = static_cast<size_t>(state.range(0));
+  BLSPublicKey groupKey;
+  std::vector<BLSSecretKey> shares;
+  std::tie(groupKey, shares) = ndnBLSDealKeyShares(threshold, threshold);
+  std::vector<BLSSignature> pieces(threshold);
+  std::vector<uint64_t> ids(threshold);
+  for (size_t i = 0; i < threshold; i++) {
+    blsSign(&pieces[i], &shares[i], MESSAGE.data(), MESSAGE.size());
+    ids[i] = i + 1;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ndnBLSRecoverSignature(pieces, ids));
+  }
+}
+BENCHMARK(BM_RecoverThresholdSignature)->RangeMultiplier(4)->Range(1, 256);
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,160 @@
+#include "ndnmps/crypto-helpers.hpp"
+#include <benchmark/benchmark.h>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+static Buffer
+makeRandomBuffer(size_t size)
+{
+  Buffer buffer(size);
+  random::generateSecureBytes(buffer.data(), buffer.size());
+  return buffer;
+}
+
+// one side of the handshake: a fresh key pair and the shared secret
+static void
+BM_EcdhHandshake(benchmark::State& state)
+{
+  ECDHState peer;
+  auto peerKey = peer.getSelfPubKey();
+  for (auto _ : state) {
+    ECDHState self;
+    self.getSelfPubKey();
+    benchmark::DoNotOptimize(self.deriveSecret(peerKey));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EcdhHandshake)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+BM_EcdhHandshakeWithKeyPool(benchmark::State& state)
+{
+  static ECDHKeyPool pool;
+  ECDHState peer;
+  auto peerKey = peer.getSelfPubKey();
+  for (auto _ : state) {
+    ECDHState self(&pool);
+    self.getSelfPubKey();
+    benchmark::DoNotOptimize(self.deriveSecret(peerKey));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EcdhHandshakeWithKeyPool)->ThreadRange(1, 8)->UseRealTime();
+
+static void
+BM_Hkdf(benchmark::State& state)
+{
+  auto secret = makeRandomBuffer(32);
+  auto salt = makeRandomBuffer(32);
+  std::vector<uint8_t> output(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hkdf(secret.data(), secret.size(), salt.data(), salt.size(),
+                                  output.data(), output.size()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Hkdf)->RangeMultiplier(2)->Range(16, 128);
+
+static void
+BM_HmacSha256(benchmark::State& state)
+{
+  auto key = makeRandomBuffer(32);
+  auto payload = makeRandomBuffer(state.range(0));
+  uint8_t result[32];
+  for (auto _ : state) {
+    hmacSha256(payload.data(), payload.size(), key.data(), key.size(), result);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HmacSha256)->RangeMultiplier(8)->Range(64, 8192)->ThreadRange(1, 8)->UseRealTime();
+
+// encryption and decryption of one payload, with the key schedule computed for every packet
+static void
+BM_AesGcmOneOffKey(benchmark::State& state)
+{
+  auto key = makeRandomBuffer(16);
+  auto payload = makeRandomBuffer(state.range(0));
+  for (auto _ : state) {
+    auto block = encodeBlockWithAesGcm128(ndn::tlv::Content, key.data(), payload.data(), payload.size(), nullptr, 0);
+    benchmark::DoNotOptimize(decodeBlockWithAesGcm128(block, key.data(), nullptr, 0));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AesGcmOneOffKey)->RangeMultiplier(8)->Range(64, 8192);
+
+static void
+BM_AesGcmSession(benchmark::State& state)
+{
+  auto key = makeRandomBuffer(16);
+  auto payload = makeRandomBuffer(state.range(0));
+  AesGcm128Session session;
+  session.setKey(key.data());
+  for (auto _ : state) {
+    auto block = encodeBlockWithAesGcm128(ndn::tlv::Content, session, payload.data(), payload.size(), nullptr, 0);
+    benchmark::DoNotOptimize(decodeBlockWithAesGcm128(block, session, nullptr, 0));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AesGcmSession)->RangeMultiplier(8)->Range(64, 8192);
+
+static void
+BM_AesGcmSessionInPlace(benchmark::State& state)
+{
+  auto key = makeRandomBuffer(16);
+  auto payload = makeRandomBuffer(state.range(0));
+  AesGcm128Session session;
+  session.setKey(key.data());
+  for (auto _ : state) {
+    EncodingBuffer encoder(payload.size() + 64, 0);
+    prependBlockWithAesGcm128(encoder, ndn::tlv::Content, session, payload.data(), payload.size(), nullptr, 0);
+    benchmark::DoNotOptimize(decryptBlockWithAesGcm128InPlace(encoder.buf(), encoder.size(), session, nullptr, 0));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AesGcmSessionInPlace)->RangeMultiplier(8)->Range(64, 8192);
+
+// HMAC signing of a result packet through KeyChain: the key is imported into the TPM for every packet
+static void
+BM_HmacDataKeyChain(benchmark::State& state)
+{
+  security::KeyChain keyChain("pib-memory:", "tpm-memory:");
+  auto key = makeRandomBuffer(32);
+  auto content = makeRandomBuffer(state.range(0));
+  Data data(Name("/signer/mps/result/1/2/3"));
+  data.setContent(content.data(), content.size());
+  for (auto _ : state) {
+    security::SigningInfo signingInfo;
+    signingInfo.setSigningHmacKey(base64EncodeFromBytes(key.data(), key.size(), false));
+    signingInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
+    keyChain.sign(data, signingInfo);
+    benchmark::DoNotOptimize(security::verifySignature(data, keyChain.getTpm(), signingInfo.getSignerName(),
+                                                       DigestAlgorithm::SHA256));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HmacDataKeyChain)->RangeMultiplier(8)->Range(64, 8192);
+
+static void
+BM_HmacDataRawKey(benchmark::State& state)
+{
+  auto key = makeRandomBuffer(32);
+  auto content = makeRandomBuffer(state.range(0));
+  Data data(Name("/signer/mps/result/1/2/3"));
+  data.setContent(content.data(), content.size());
+  for (auto _ : state) {
+    signDataWithHmacSha256(data, key.data(), key.size());
+    benchmark::DoNotOptimize(verifyDataWithHmacSha256(data, key.data(), key.size()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HmacDataRawKey)->RangeMultiplier(8)->Range(64, 8192);
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,169 @@
+#include "ndnmps/initiator.hpp"
+#include "ndnmps/metrics.hpp"
+#include "ndnmps/signer.hpp"
+#include "ndnmps/tracer.hpp"
+#include "ndnmps/verifier.hpp"
+#include "virtual-network.hpp"
+#include <benchmark/benchmark.h>
+#include <ndn-cxx/util/random.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+// sessions still running after the deadline fail
+static const time::seconds SESSION_DEADLINE(30);
+
+/**
+ * One multiPartySign session per iteration, from the call until the verifier has checked the result.
+ *
+ * Arguments: number of signers, delay of each link to the hub in milliseconds, and loss rate of each
+ * link in per mille. With loss, a quarter more signers are online so that the initiator can replace
+ * the signers whose requests are lost.
+ *
+ * Counters: latency percentiles of the successful sessions, signed packets and signature pieces per second,
+ * the packets and octets sent per session, and the median of each protocol phase recorded by Metrics.
+ *
+ * If NDNMPS_TRACE_FILE is set, the spans of the sessions are written to that file in the Chrome trace format.
+ */
+static void
+BM_MultiPartySession(benchmark::State& state)
+{
+  ndnBLSInit();
+  const size_t signerCount = state.range(0);
+  const size_t spareCount = state.range(2) > 0 ? signerCount / 4 + 1 : 0;
+  VirtualNetwork::LinkParams link;
+  link.m_delay = time::milliseconds(state.range(1));
+  link.m_lossRate = state.range(2) / 1000.0;
+
+  boost::asio::io_service io;
+  security::KeyChain keyChain("pib-memory:", "tpm-memory:");
+  auto initiatorId = keyChain.createIdentity(Name("/bench/initiator"));
+  VirtualNetwork network(io);
+  Scheduler scheduler(io);
+
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < signerCount + spareCount; i++) {
+    Name prefix("/bench/signer" + std::to_string(i));
+    signers.emplace_back(make_unique<BLSSigner>(prefix, network.addFace(keyChain, link), keyChain,
+                                                Name(prefix).append("KEY").append("1")));
+  }
+  MPSInitiator initiator(Name("/bench/initiator"), keyChain, network.addFace(keyChain, link), scheduler);
+  BLSVerifier verifier(network.addFace(keyChain, link));
+
+  // any signerCount of the online signers
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/bench/data/*");
+  schema.m_ruleId = "bench";
+  WildCardName signerPattern("/bench/*/KEY/1");
+  signerPattern.m_times = signerCount + spareCount;
+  schema.m_optionalSigners.push_back(signerPattern);
+  schema.m_minOptionalSigners = signerCount;
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  for (const auto& signer : signers) {
+    initiator.m_schemaContainer.m_trustedIds.emplace(signer->getPublicKeyName(), signer->getPublicKey());
+    verifier.m_schemaContainer.m_trustedIds.emplace(signer->getPublicKeyName(), signer->getPublicKey());
+  }
+  // answer the prefix registrations
+  io.poll();
+  io.reset();
+  network.resetCounters();
+  Metrics::get().reset();
+  Metrics::setEnabled(true);
+  const char* traceFile = std::getenv("NDNMPS_TRACE_FILE");
+  if (traceFile != nullptr) {
+    Tracer::get().clear();
+    Tracer::setEnabled(true);
+  }
+
+  Buffer content(1024);
+  random::generateSecureBytes(content.data(), content.size());
+  std::vector<double> latencies;
+  size_t failureCount = 0;
+  uint64_t sessionId = 0;
+  for (auto _ : state) {
+    Data unsignedData(Name("/bench/data").appendNumber(sessionId++));
+    unsignedData.setContent(content.data(), content.size());
+    bool isValid = false;
+    auto begin = std::chrono::steady_clock::now();
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const Data& signedData, const Data& infoData) {
+                               isValid = verifier.verify(signedData, infoData);
+                               io.stop();
+                             },
+                             [&](const std::string&) {
+                               io.stop();
+                             },
+                             SESSION_DEADLINE);
+    io.run();
+    io.reset();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    state.SetIterationTime(elapsed.count());
+    if (isValid) {
+      latencies.push_back(elapsed.count());
+    }
+    else {
+      failureCount++;
+    }
+  }
+
+  Metrics::setEnabled(false);
+  if (traceFile != nullptr) {
+    // each case overwrites the file, so filter for the case of interest
+    Tracer::setEnabled(false);
+    Tracer::get().writeChromeTrace(std::string(traceFile));
+  }
+  for (const auto& item : Metrics::get().snapshotHistograms()) {
+    if (item.second.m_count > 0) {
+      state.counters[item.first + ".p50_us"] = item.second.getPercentile(50) / 1000.0;
+    }
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies] (double p) {
+    if (latencies.empty()) {
+      return 0.0;
+    }
+    auto index = std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()));
+    return latencies[index] * 1000;
+  };
+  state.counters["p50_ms"] = percentile(0.5);
+  state.counters["p90_ms"] = percentile(0.9);
+  state.counters["p99_ms"] = percentile(0.99);
+  state.counters["max_ms"] = percentile(1);
+  state.counters["failures"] = failureCount;
+  state.counters["signatures_per_s"] = benchmark::Counter(latencies.size(), benchmark::Counter::kIsRate);
+  state.counters["pieces_per_s"] = benchmark::Counter(latencies.size() * signerCount,
+                                                      benchmark::Counter::kIsRate);
+  state.counters["packets_per_session"] = benchmark::Counter(network.getPacketCount(),
+                                                             benchmark::Counter::kAvgIterations);
+  state.counters["wire_bytes_per_session"] = benchmark::Counter(network.getWireBytes(),
+                                                                benchmark::Counter::kAvgIterations);
+}
+
+static void
+sessionArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int64_t signerCount = 1; signerCount <= 256; signerCount <<= 1) {
+    bench->Args({signerCount, 0, 0});
+    bench->Args({signerCount, 10, 0});
+  }
+  // lost requests are only detected by Interest timeouts, so these sessions take seconds
+  for (int64_t signerCount : {1, 4, 16}) {
+    bench->Args({signerCount, 10, 10});
+  }
+}
+BENCHMARK(BM_MultiPartySession)
+  ->ArgNames({"signers", "delay_ms", "loss_permille"})
+  ->Apply(sessionArguments)
+  ->Iterations(20)
+  ->UseManualTime()
+  ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
@@ -0,0 +1,126 @@
+#include "ndnmps/schema.hpp"
+#include <benchmark/benchmark.h>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+static std::vector<Name>
+makeSignerNames(size_t size)
+{
+  std::vector<Name> names;
+  for (size_t i = 0; i < size; i++) {
+    names.emplace_back("/example/signer" + std::to_string(i) + "/KEY/1");
+  }
+  return names;
+}
+
+// a schema requiring every signer of makeSignerNames
+static MultipartySchema
+makeSchema(size_t size)
+{
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/example/data");
+  schema.m_ruleId = "bench";
+  for (size_t i = 0; i < size; i++) {
+    schema.m_signers.emplace_back("/example/signer" + std::to_string(i) + "/KEY/*");
+  }
+  schema.m_minOptionalSigners = 0;
+  return schema;
+}
+
+static void
+BM_SignerListEncode(benchmark::State& state)
+{
+  MpsSignerList signers(makeSignerNames(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(signers.wireEncode());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignerListEncode)->RangeMultiplier(4)->Range(1, 1024);
+
+static void
+BM_SignerListDecode(benchmark::State& state)
+{
+  auto wire = MpsSignerList(makeSignerNames(state.range(0))).wireEncode();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MpsSignerList(wire));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignerListDecode)->RangeMultiplier(4)->Range(1, 1024);
+
+static void
+BM_SignerListViewDecode(benchmark::State& state)
+{
+  auto wire = MpsSignerList(makeSignerNames(state.range(0))).wireEncode();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(MpsSignerListView(wire));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignerListViewDecode)->RangeMultiplier(4)->Range(1, 1024);
+
+// worst case of the comparison: equal sets, so the hashes match and the names are compared
+static void
+BM_SignerListViewEquality(benchmark::State& state)
+{
+  auto names = makeSignerNames(state.range(0));
+  MpsSignerListView lhs(MpsSignerList(names).wireEncode());
+  MpsSignerListView rhs(MpsSignerList(names).wireEncode());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs == rhs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignerListViewEquality)->RangeMultiplier(4)->Range(1, 1024);
+
+static void
+BM_PassSchema(benchmark::State& state)
+{
+  auto schema = makeSchema(state.range(0));
+  auto names = makeSignerNames(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(schema.passSchema(names));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PassSchema)->RangeMultiplier(4)->Range(1, 256);
+
+static void
+BM_PassSchemaView(benchmark::State& state)
+{
+  auto schema = makeSchema(state.range(0));
+  MpsSignerListView view(MpsSignerList(makeSignerNames(state.range(0))).wireEncode());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(schema.passSchema(view));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PassSchemaView)->RangeMultiplier(4)->Range(1, 256);
+
+static void
+BM_ContainerAggregateKey(benchmark::State& state)
+{
+  ndnBLSInit();
+  auto names = makeSignerNames(state.range(0));
+  MultipartySchemaContainer container;
+  for (const auto& name : names) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    container.m_trustedIds.emplace(name, pk);
+  }
+  MpsSignerList signers(names);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(container.aggregateKey(signers));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ContainerAggregateKey)->RangeMultiplier(4)->Range(1, 1024);
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
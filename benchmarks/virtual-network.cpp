@@ -0,0 +1,72 @@
+#include "virtual-network.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+#include <random>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+static const Name LOCALHOST_PREFIX("/localhost");
+
+VirtualNetwork::VirtualNetwork(boost::asio::io_service& io)
+  : m_io(io)
+  , m_scheduler(io)
+{
+}
+
+util::DummyClientFace&
+VirtualNetwork::addFace(KeyChain& keyChain, const LinkParams& link)
+{
+  auto index = m_faces.size();
+  m_faces.push_back(make_unique<util::DummyClientFace>(m_io, keyChain, util::DummyClientFace::Options{false, true}));
+  m_links.push_back(link);
+  auto& face = *m_faces.back();
+  m_connections.push_back(face.onSendInterest.connect([this, index](const Interest& interest) {
+    if (!LOCALHOST_PREFIX.isPrefixOf(interest.getName())) {
+      transmit(index, interest, interest.wireEncode().size());
+    }
+  }));
+  m_connections.push_back(face.onSendData.connect([this, index](const Data& data) {
+    transmit(index, data, data.wireEncode().size());
+  }));
+  m_connections.push_back(face.onSendNack.connect([this, index](const lp::Nack& nack) {
+    transmit(index, nack, nack.getInterest().wireEncode().size());
+  }));
+  return face;
+}
+
+template<typename Packet>
+void
+VirtualNetwork::transmit(size_t senderIndex, const Packet& packet, size_t wireSize)
+{
+  m_wireBytes += wireSize;
+  m_packetCount++;
+  const auto& uplink = m_links[senderIndex];
+  if (isDropped(uplink)) {
+    return;
+  }
+  for (size_t i = 0; i < m_faces.size(); i++) {
+    if (i == senderIndex || isDropped(m_links[i])) {
+      continue;
+    }
+    auto* face = m_faces[i].get();
+    m_scheduler.schedule(uplink.m_delay + m_links[i].m_delay, [face, packet] {
+      face->receive(packet);
+    });
+  }
+}
+
+bool
+VirtualNetwork::isDropped(const LinkParams& link)
+{
+  if (link.m_lossRate <= 0) {
+    return false;
+  }
+  std::bernoulli_distribution dist(link.m_lossRate);
+  return dist(random::getRandomNumberEngine());
+}
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
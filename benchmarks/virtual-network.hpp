@@ -0,0 +1,85 @@
+#ifndef NDNMPS_BENCHMARKS_VIRTUAL_NETWORK_HPP
+#define NDNMPS_BENCHMARKS_VIRTUAL_NETWORK_HPP
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/signal.hpp>
+#include <memory>
+#include <vector>
+
+namespace ndn {
+namespace mps {
+namespace bench {
+
+/**
+ * @brief An in-process network connecting DummyClientFaces through a hub.
+ *
+ * A packet sent by a face is delivered to every other face after the delay of the sender's link
+ * plus the delay of the receiver's link, unless one of the two links drops it. Faces only accept
+ * Interests matching their filters and Data matching their pending Interests, so the hub acts like
+ * a forwarder with routes to all prefixes. Prefix registration commands are answered by the faces
+ * themselves and are not forwarded.
+ */
+class VirtualNetwork : noncopyable
+{
+public:
+  struct LinkParams
+  {
+    time::milliseconds m_delay = time::milliseconds(0);
+    double m_lossRate = 0; // probability of dropping a packet in each direction
+  };
+
+  explicit
+  VirtualNetwork(boost::asio::io_service& io);
+
+  /**
+   * Add a face linked to the hub. The face is owned by the network.
+   */
+  util::DummyClientFace&
+  addFace(KeyChain& keyChain, const LinkParams& link);
+
+  /**
+   * @return the octets of all packets sent by the faces, counted once per packet.
+   */
+  uint64_t
+  getWireBytes() const
+  {
+    return m_wireBytes;
+  }
+
+  uint64_t
+  getPacketCount() const
+  {
+    return m_packetCount;
+  }
+
+  void
+  resetCounters()
+  {
+    m_wireBytes = 0;
+    m_packetCount = 0;
+  }
+
+private:
+  template<typename Packet>
+  void
+  transmit(size_t senderIndex, const Packet& packet, size_t wireSize);
+
+  bool
+  isDropped(const LinkParams& link);
+
+private:
+  boost::asio::io_service& m_io;
+  Scheduler m_scheduler;
+  std::vector<std::unique_ptr<util::DummyClientFace>> m_faces;
+  std::vector<LinkParams> m_links;
+  std::vector<util::signal::ScopedConnection> m_connections;
+  uint64_t m_wireBytes = 0;
+  uint64_t m_packetCount = 0;
+};
+
+}  // namespace bench
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_BENCHMARKS_VIRTUAL_NETWORK_HPP
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <map>
+#include <tuple>
 
 namespace ndn {
 namespace mps {
@@ -21,6 +22,16 @@ using BLSSignature = blsSignature;
 void
 ndnBLSInit();
 
+/**
+ * Set the capacity of the process-wide signing caches of ndnGenBLSSignature and ndnBLSSign.
+ * One cache keeps the message hashes (points of G2) of recently signed packets, so signers of the same
+ * process sharing a packet hash it once; the other keeps the recent signatures per secret key,
+ * so signing a byte-identical packet again, e.g. for a retried request, costs two SHA-256 digests.
+ * Each cache keeps at most capacity entries. The caches are disabled by the default capacity of zero.
+ */
+void
+ndnBLSSetSignatureCacheCapacity(size_t capacity);
+
 /**
  * Return the signature value for the packet.
  * @param data the unsigned data packet
@@ -98,6 +109,17 @@ security::Certificate
 ndnGenBLSSelfCert(const BLSPublicKey& pubKey, const BLSSecretKey& signingKey,
                   const security::ValidityPeriod& period);
 
+/**
+ * generate a self signed certificate for the key, whose signature also serves as the proof of possession
+ * @param keyName the key name, the certificate name will be /keyName/self/[random]
+ * @param period the expected validity period
+ * @return the generated certificate
+ */
+security::Certificate
+genSelfSignedCertificate(const Name& keyName,
+                         const BLSPublicKey& pubKey, const BLSSecretKey& signingKey,
+                         const security::ValidityPeriod& period);
+
 bool
 ndnBLSVerify(const BLSPublicKey& pubKey, const Data& data);
 
@@ -110,12 +132,110 @@ ndnBLSVerify(const BLSPublicKey& pubKey, const Interest& interest);
 bool
 ndnBLSVerify(const std::vector<BLSPublicKey>& pubKeys, const Interest& interest);
 
+/**
+ * Verify signatures over different messages with one multi-pairing check.
+ * Each pair is weighted with a random 64-bit scalar, so invalid signatures cannot cancel each other out.
+ * @param pubKeys the public key of each signature
+ * @param signatures the signatures to be verified
+ * @param messages the signed message of each signature
+ * @return true if all the signatures are valid
+ */
+bool
+ndnBLSBatchVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                  const std::vector<Buffer>& messages);
+
+/**
+ * Find the invalid signatures in a batch. The batch is checked as a whole first
+ * and bisected only when the check fails.
+ * @return the indexes of the invalid signatures, in increasing order
+ */
+std::vector<size_t>
+ndnBLSFindInvalidSignatures(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                            const std::vector<Buffer>& messages);
+
+/**
+ * Verify signatures over the same message with one multi-pairing check of two pairings:
+ * e(sum(r_i * pk_i), H(m)) == e(g1, sum(r_i * sig_i)) with random 64-bit scalars r_i.
+ * @param pubKeys the public key of each signature
+ * @param signatures the signatures to be verified
+ * @param message the message signed by all the keys
+ * @return true if all the signatures are valid
+ */
+bool
+ndnBLSBatchVerifySameMessage(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                             const Buffer& message);
+
+/**
+ * Find the invalid signatures over the same message. The batch is checked as a whole first
+ * and bisected only when the check fails.
+ * @return the indexes of the invalid signatures, in increasing order
+ */
+std::vector<size_t>
+ndnBLSFindInvalidSignaturesSameMessage(const std::vector<BLSPublicKey>& pubKeys,
+                                       const std::vector<BLSSignature>& signatures, const Buffer& message);
+
+/**
+ * Verify an aggregate of signatures over distinct messages, each by its own key, with one multi-pairing:
+ * e(g1, sig) == prod(e(pk_i, H(m_i))).
+ * The messages must be distinct, since an aggregate over repeated messages can be forged with rogue keys.
+ * @param pubKeys the public key of each message
+ * @param messages the signed messages
+ * @param aggregateSignature the sum of the signatures over the messages
+ * @return true if the aggregate is valid and the messages are distinct
+ * @throw std::runtime_error if the numbers of keys and messages do not match
+ */
+bool
+ndnBLSAggregateVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Buffer>& messages,
+                      const BLSSignature& aggregateSignature);
+
+/**
+ * Verify an aggregate of signatures over distinct Data packets. The message of each packet is its signed portion,
+ * so the signature of each packet is the one of ndnGenBLSSignature.
+ */
+bool
+ndnBLSAggregateVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Data>& packets,
+                      const BLSSignature& aggregateSignature);
+
+/**
+ * Deal the shares of a fresh t-of-n group key (Shamir secret sharing by a trusted dealer).
+ * The key share with id i (1 <= i <= n) is the evaluation of a random polynomial of degree t - 1 at i,
+ * whose constant term is the group secret key. The group secret key is discarded afterwards.
+ * @param threshold the number of pieces t needed for a signature of the group key.
+ * @param shareCount the number of shares n.
+ * @return the group public key and the key shares; the share at position i has id i + 1.
+ * @throw std::runtime_error if threshold is zero or larger than shareCount.
+ */
+std::tuple<BLSPublicKey, std::vector<BLSSecretKey>>
+ndnBLSDealKeyShares(size_t threshold, size_t shareCount);
+
+/**
+ * Combine the signature pieces of t key shares into the signature of the group key by Lagrange interpolation.
+ * @param pieces the signature pieces over the same message.
+ * @param shareIds the id of the key share of each piece.
+ * @throw std::runtime_error if the ids are zero or repeated, or the numbers of pieces and ids do not match.
+ */
+BLSSignature
+ndnBLSRecoverSignature(const std::vector<BLSSignature>& pieces, const std::vector<uint64_t>& shareIds);
+
+/**
+ * Aggregate the public keys, with a single normalization of the sum.
+ * Sets of 1024 or more keys are summed by multiple threads.
+ * @throw std::runtime_error if the keys are empty.
+ */
 BLSPublicKey
 ndnBLSAggregatePublicKey(const std::vector<BLSPublicKey>& pubKeys);
 
+/**
+ * Aggregate the serialized signatures.
+ * @throw std::runtime_error if the signatures are empty or cannot be deserialized.
+ */
 Buffer
 ndnBLSAggregateSignature(const std::vector<Buffer>& signatures);
 
+/**
+ * Aggregate the signatures, in the same way as ndnBLSAggregatePublicKey.
+ * @throw std::runtime_error if the signatures are empty.
+ */
 BLSSignature
 ndnBLSAggregateSignature(const std::vector<BLSSignature>& signatures);
 
@@ -35,11 +35,26 @@ enum : uint32_t {
   AuthenticationTag = 175,
 
   MpsSignerList = 200,
+  MpsRosterSignerList = 201,
   Status = 203,
   ParameterDataName = 205,
   ResultAfter = 209,
   ResultName = 211,
-  BLSSigValue = 213
+  BLSSigValue = 213,
+  RosterDigest = 215,
+  RosterVersion = 217,
+  SignerBitmap = 219,
+  SignerIndexDeltas = 221,
+  PayloadKey = 223,
+  ContentKey = 225,
+  PayloadName = 227,
+  Ticket = 229,
+  TicketId = 231,
+  TicketLifetime = 233,
+  TicketBudget = 235,
+  TicketCounter = 237,
+  DataBundle = 239,
+  TraceId = 241
 };
 
 /** @brief Extended SignatureType values with Multi-Party Signature
@@ -22,11 +22,61 @@
 #define NDNMPS_CRYPTO_HELPERS_HPP
 
 #include "common.hpp"
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
 #include <openssl/evp.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace ndn {
 namespace mps {
 
+/**
+ * @brief A pool of pregenerated ephemeral prime256v1 key pairs for ECDH.
+ *
+ * A background thread generates key pairs until the pool holds @p capacity keys, and starts again
+ * whenever the number of keys drops to @p lowWaterMark. When the pool is empty, a key pair is
+ * generated on the calling thread, so taking a key never blocks on the refill thread.
+ */
+class ECDHKeyPool : noncopyable
+{
+public:
+  /**
+   * @param capacity the number of key pairs the refill thread keeps in the pool.
+   * @param lowWaterMark the number of key pairs at which the refill thread is woken up.
+   */
+  explicit
+  ECDHKeyPool(size_t capacity = 64, size_t lowWaterMark = 16);
+
+  ~ECDHKeyPool();
+
+  /**
+   * @brief Take a key pair out of the pool.
+   * @return the key pair, owned by the caller.
+   * @throw runtime_error if the pool is empty and a key pair cannot be generated.
+   */
+  EVP_PKEY*
+  take();
+
+  size_t
+  size() const;
+
+private:
+  void
+  refill();
+
+private:
+  const size_t m_capacity;
+  const size_t m_lowWaterMark;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_refillCv;
+  std::deque<EVP_PKEY*> m_keys;
+  bool m_isStopped = false;
+  std::thread m_refillThread;
+};
+
 /**
  * @brief State for ECDH.
  *
@@ -36,6 +86,13 @@ class ECDHState : noncopyable
 {
 public:
   ECDHState();
+
+  /**
+   * @brief Use a key pair from the pool, or generate one if @p pool is nullptr.
+   */
+  explicit
+  ECDHState(ECDHKeyPool* pool);
+
   ~ECDHState();
 
   /**
@@ -75,6 +132,7 @@ private:
  * @param info The additional information used in HKDF.
  * @param infoLen The length of the additional information.
  * @return size_t The length of the derived key if successful.
+ * @note This is RFC 5869 HKDF-SHA256 built on the per-thread HMAC context of hmacSha256.
  */
 size_t
 hkdf(const uint8_t* secret, size_t secretLen,
@@ -82,6 +140,23 @@ hkdf(const uint8_t* secret, size_t secretLen,
      uint8_t* output, size_t outputLen,
      const uint8_t* info = nullptr, size_t infoLen = 0);
 
+/**
+ * @brief Derive the keys of a resumed session request from the resumption secret.
+ *
+ * The keys are the HKDF output of the secret, salted with the request counter and the ticket ID
+ * (8 octets each, in network byte order), so every request gets fresh keys.
+ *
+ * @param secret The resumption secret from the full handshake.
+ * @param secretLen The length of the secret.
+ * @param ticketId The ID of the resumption ticket.
+ * @param counter The request counter, which must not be reused with the same ticket.
+ * @param output The derived keys.
+ * @param outputLen The length of expected output.
+ */
+void
+deriveResumedKeys(const uint8_t* secret, size_t secretLen, uint64_t ticketId, uint64_t counter,
+                  uint8_t* output, size_t outputLen);
+
 /**
  * @brief HMAC based on SHA-256.
  *
@@ -91,12 +166,41 @@ hkdf(const uint8_t* secret, size_t secretLen,
  * @param keyLen The length of the HMAC key.
  * @param result The result of the HMAC. Enough memory (32 Bytes) must be allocated beforehands.
  * @throw runtime_error when an error occurred in the underlying HMAC.
+ * @note The HMAC context is allocated once per thread and reused.
  */
 void
 hmacSha256(const uint8_t* data, size_t dataLen,
            const uint8_t* key, size_t keyLen,
            uint8_t* result);
 
+/**
+ * @brief Sign the Data packet with HMAC-SHA256 using the raw key.
+ *
+ * The packet gets a SignatureHmacWithSha256 SignatureInfo without KeyLocator, and is encoded once.
+ * Unlike signing with KeyChain and SigningInfo::setSigningHmacKey, the key is not imported into the TPM.
+ * KeyChain also sets the HMAC key name as the KeyLocator, so the SignatureInfo and thus the signed
+ * portion and the signature value differ from the KeyChain ones. Only verification interoperates:
+ * verifyDataWithHmacSha256 accepts packets signed either way with the same key.
+ *
+ * @param data The Data packet to be signed.
+ * @param key The HMAC key.
+ * @param keyLen The length of the HMAC key.
+ * @throw runtime_error when an error occurred in the underlying HMAC.
+ */
+void
+signDataWithHmacSha256(Data& data, const uint8_t* key, size_t keyLen);
+
+/**
+ * @brief Verify the HMAC-SHA256 signature of the Data packet using the raw key.
+ *
+ * @param data The Data packet to be verified.
+ * @param key The HMAC key.
+ * @param keyLen The length of the HMAC key.
+ * @return true if the packet is signed with SignatureHmacWithSha256 and the signature value matches.
+ */
+bool
+verifyDataWithHmacSha256(const Data& data, const uint8_t* key, size_t keyLen);
+
 /**
  * @brief Authenticated GCM 128 Encryption with associated data.
  *
@@ -133,6 +237,52 @@ size_t
 aesGcm128Decrypt(const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* associated, size_t associatedLen,
                  const uint8_t* tag, const uint8_t* key, const uint8_t* iv, uint8_t* plaintext);
 
+/**
+ * @brief AES-GCM-128 contexts keyed once and reused for all packets of a session.
+ *
+ * Each call only resets the IV, so the key schedule is not recomputed per packet.
+ * A session must not be used by multiple threads at the same time.
+ */
+class AesGcm128Session : noncopyable
+{
+public:
+  AesGcm128Session();
+  ~AesGcm128Session();
+
+  /**
+   * @brief Key the encryption and decryption contexts.
+   * @param key 16 bytes AES key.
+   * @throw runtime_error when the contexts cannot be initialized.
+   */
+  void
+  setKey(const uint8_t* key);
+
+  bool
+  hasKey() const
+  {
+    return m_hasKey;
+  }
+
+  /**
+   * @brief Same as aesGcm128Encrypt, with the key of this session.
+   */
+  size_t
+  encrypt(const uint8_t* plaintext, size_t plaintextLen, const uint8_t* associated, size_t associatedLen,
+          const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag);
+
+  /**
+   * @brief Same as aesGcm128Decrypt, with the key of this session.
+   */
+  size_t
+  decrypt(const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* associated, size_t associatedLen,
+          const uint8_t* tag, const uint8_t* iv, uint8_t* plaintext);
+
+private:
+  EVP_CIPHER_CTX* m_encryptCtx = nullptr;
+  EVP_CIPHER_CTX* m_decryptCtx = nullptr;
+  bool m_hasKey = false;
+};
+
 /**
  * @brief Encode the payload into TLV block with Authenticated GCM 128 Encryption.
  *
@@ -151,6 +301,14 @@ encodeBlockWithAesGcm128(uint32_t tlvType, const uint8_t* key,
                          const uint8_t* payload, size_t payloadSize,
                          const uint8_t* associatedData, size_t associatedDataSize);
 
+/**
+ * @brief Same as above, with the key of an AES-GCM session.
+ */
+Block
+encodeBlockWithAesGcm128(uint32_t tlvType, AesGcm128Session& session,
+                         const uint8_t* payload, size_t payloadSize,
+                         const uint8_t* associatedData, size_t associatedDataSize);
+
 /**
  * @brief Decode the payload from TLV block with Authenticated GCM 128 Encryption.
  *
@@ -166,6 +324,50 @@ Buffer
 decodeBlockWithAesGcm128(const Block& block, const uint8_t* key,
                          const uint8_t* associatedData, size_t associatedDataSize);
 
+/**
+ * @brief Same as above, with the key of an AES-GCM session.
+ */
+Buffer
+decodeBlockWithAesGcm128(const Block& block, AesGcm128Session& session,
+                         const uint8_t* associatedData, size_t associatedDataSize);
+
+/**
+ * @brief Prepend the AES-GCM encrypted TLV block to an encoder, without intermediate buffers.
+ *
+ * The payload is copied into the encoder once and encrypted in place, then the TLV headers,
+ * the tag, and the IV are prepended in front of it. The layout is the same as encodeBlockWithAesGcm128.
+ *
+ * @param encoder The encoder, which should have enough front space reserved for the payload and about 64 octets.
+ * @param tlvType The TLV TYPE of the encoded block, either ApplicationParameters or Content.
+ * @param session The AES-GCM session holding the key.
+ * @param payload The plaintext payload.
+ * @param payloadSize The size of the plaintext payload.
+ * @param associatedData The associated data used for authentication.
+ * @param associatedDataSize The size of associated data.
+ * @return size_t The number of octets prepended.
+ */
+size_t
+prependBlockWithAesGcm128(EncodingBuffer& encoder, uint32_t tlvType, AesGcm128Session& session,
+                          const uint8_t* payload, size_t payloadSize,
+                          const uint8_t* associatedData, size_t associatedDataSize);
+
+/**
+ * @brief Decrypt the AES-GCM encrypted TLV block in place.
+ *
+ * The TLV is parsed directly from the wire, and the plaintext overwrites the encrypted payload.
+ *
+ * @param wire The wire encoding of the whole block, which is modified.
+ * @param wireSize The size of the wire encoding.
+ * @param session The AES-GCM session holding the key.
+ * @param associatedData The associated data used for authentication.
+ * @param associatedDataSize The size of associated data.
+ * @return the offset of the plaintext in @p wire and its size.
+ * @throw runtime_error if the block is malformed or cannot be authenticated.
+ */
+std::tuple<size_t, size_t>
+decryptBlockWithAesGcm128InPlace(uint8_t* wire, size_t wireSize, AesGcm128Session& session,
+                                 const uint8_t* associatedData, size_t associatedDataSize);
+
 std::string
 base64EncodeFromBytes(const uint8_t* data, size_t len, bool needBreak);
 
@@ -0,0 +1,73 @@
+#ifndef NDNMPS_DATA_BUNDLE_HPP
+#define NDNMPS_DATA_BUNDLE_HPP
+
+#include "bls-helpers.hpp"
+#include <vector>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * @brief A series of Data packets, e.g. the segments of one object, that share one aggregate BLS signature.
+ *
+ *   DataBundle = DATA-BUNDLE-TYPE TLV-LENGTH 1*Data BLSSigValue
+ *
+ * Each packet carries its own SignatureInfo (SignatureSha256WithBls with the KeyLocator of its signer)
+ * and an empty SignatureValue. BLSSigValue is the sum of the signatures of all packets over their signed
+ * portions, so the whole bundle is checked with ndnBLSAggregateVerify in one multi-pairing.
+ */
+class BLSDataBundle
+{
+public:
+  BLSDataBundle();
+
+  /**
+   * Decode a bundle from wire encoding.
+   * @throw ndn::tlv::Error if the block is not a valid bundle.
+   */
+  explicit
+  BLSDataBundle(const Block& wire);
+
+  /**
+   * Sign the packet and add its signature to the aggregate.
+   * @param data the unsigned packet.
+   * @param signingKey the key of the signer.
+   * @param keyName the key name of the signer, put into the KeyLocator of the packet.
+   */
+  void
+  addPacket(Data data, const BLSSecretKey& signingKey, const Name& keyName);
+
+  const std::vector<Data>&
+  getPackets() const
+  {
+    return m_packets;
+  }
+
+  const BLSSignature&
+  getAggregateSignature() const
+  {
+    return m_aggregateSignature;
+  }
+
+  /**
+   * @return the key names in the KeyLocators of the packets, in the order of the packets.
+   * @throw std::runtime_error if a packet has no key name as KeyLocator.
+   */
+  std::vector<Name>
+  getSignerKeyNames() const;
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  std::vector<Data> m_packets;
+  BLSSignature m_aggregateSignature;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_DATA_BUNDLE_HPP
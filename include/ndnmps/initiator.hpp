@@ -1,6 +1,7 @@
 #ifndef NDNMPS_INITIATOR_HPP
 #define NDNMPS_INITIATOR_HPP
 
+#include <array>
 #include <iostream>
 #include <map>
 #include <tuple>
@@ -9,6 +10,7 @@
 #include <ndn-cxx/security/interest-signer.hpp>
 
 #include "bls-helpers.hpp"
+#include "crypto-helpers.hpp"
 #include "mps-signer-list.hpp"
 #include "schema.hpp"
 
@@ -18,6 +20,18 @@ namespace mps {
 typedef function<void(const Data& data, const Data& signerListData)> SignatureFinishCallback;
 typedef function<void(const std::string& reason)> SignatureFailureCallback;
 struct MultiSignGlobalState;
+struct MultiSignPerSignerState;
+
+/**
+ * A t-of-n group key whose shares are held by the signers (see ndnBLSDealKeyShares).
+ * The public key shares of the signers must be trusted by the initiator to verify the pieces.
+ */
+struct ThresholdGroup
+{
+  Name m_groupKeyName;
+  size_t m_threshold = 0;
+  std::map<Name, uint64_t> m_shareIds; // signer key name, id of its key share
+};
 
 /**
  * The signer class class that handles functionality in the multi-signing protocol.
@@ -30,9 +44,46 @@ private:
   Scheduler& m_scheduler;
   security::InterestSigner m_interestSigner;
 
+  struct ResumptionState
+  {
+    std::array<uint8_t, 32> m_secret;
+    uint64_t m_ticketId;
+    uint64_t m_counter; // the counter of the last resumed request
+    time::steady_clock::TimePoint m_expiry;
+    uint64_t m_remainingRequests;
+  };
+  std::map<Name, ResumptionState> m_resumptions; // signer key name, resumable session
+
 public:
   const Name m_prefix;
   MultipartySchemaContainer m_schemaContainer;
+  /**
+   * Encode the signer list in the info Data as indexes into m_schemaContainer.m_roster.
+   * The verifiers must load the same roster.
+   */
+  bool m_useRosterSignerList = false;
+  // pregenerated ECDH key pairs for the handshakes, generated per signer when not set
+  std::shared_ptr<ECDHKeyPool> m_ecdhKeyPool;
+  /**
+   * Encrypt the unsigned Data once per session under a random content key and publish it as
+   * /<prefix>/mps/payload/<random>. The parameter Data of each signer then only carries the content key,
+   * encrypted with the key of that signer, and the full name of the payload Data.
+   */
+  bool m_encryptPayloadOnce = false;
+  /**
+   * Resume the sessions with signers that issued resumption tickets, so later requests to the same signer
+   * derive fresh keys from the ticket instead of running ECDH. Falls back to a full handshake when
+   * the ticket is expired, out of budget, or rejected.
+   */
+  bool m_useResumption = false;
+  /**
+   * Lifetime of the sign request and result fetch Interests. A signer that does not answer in time is replaced.
+   */
+  time::milliseconds m_requestTimeout = time::seconds(4);
+  /**
+   * How long a signer may keep answering "102 Processing" after its ACK before it is replaced.
+   */
+  time::milliseconds m_processingTimeout = time::seconds(10);
 
 public:
   MPSInitiator(const Name& prefix, KeyChain& keyChain, Face& face, Scheduler& scheduler);
@@ -43,19 +94,62 @@ public:
    * @param unfinishedData the unsigned data to be (multi-) signed, must containing signature info.
    * @param successCb the callback then the data finished signing. Also returns the signer list.
    * @param failureCb the callback then the data failed to be signed. the reason will be returned.
+   * @param timeout the deadline of the session, after which it fails.
+   *
+   * Exactly one of the callbacks is called, after all the prefixes, Interests, and events of the session
+   * have been cancelled.
    */
   void
   multiPartySign(const Data& unsignedData, const MultipartySchema& schema, const Name& signingKeyName,
-                 const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb);
+                 const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb,
+                 time::milliseconds timeout = time::seconds(30));
+
+  /**
+   * Sign the data with any t signers of a threshold group. The pieces are combined into a signature
+   * of the group key, which is the KeyLocator of the signed data. Verifiers only need the group key,
+   * so no signature info packet is produced and the success callback gets an empty info Data.
+   * @param group the threshold group, whose signers are replaced by other members when unavailable.
+   */
+  void
+  thresholdSign(const Data& unsignedData, const ThresholdGroup& group, const Name& signingKeyName,
+                const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb,
+                time::milliseconds timeout = time::seconds(30));
 
 private:
+  void
+  startSigning(const Data& unsignedData, time::milliseconds timeout,
+               std::shared_ptr<MultiSignGlobalState> globalState);
+
   void
   performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlobalState> globalState);
 
+  /**
+   * Verify the fetched signature pieces once all current signers have returned one, then aggregate them.
+   * The signers of invalid pieces are handed to onUnavailableSigner.
+   */
+  void
+  onSignaturePieceFetched(std::shared_ptr<MultiSignGlobalState> globalState);
+
   void
   onUnavailableSigner(const std::string& reason,
                       const Name& unavailbleSignerKeyName,
                       std::shared_ptr<MultiSignGlobalState> globalState);
+
+  void
+  replaceUnavailableSigners(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  void
+  preparePayloadData(std::shared_ptr<MultiSignGlobalState> globalState);
+
+  /**
+   * Derive the keys of the request from the ticket of the signer, if there is a usable one.
+   * @return true if the request resumes the session.
+   */
+  bool
+  resumeSession(MultiSignPerSignerState& perSignerState);
+
+  void
+  saveTicket(const MultiSignPerSignerState& perSignerState);
 };
 
 }  // namespace mps
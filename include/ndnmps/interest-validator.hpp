@@ -0,0 +1,97 @@
+#ifndef NDNMPS_INTEREST_VALIDATOR_HPP
+#define NDNMPS_INTEREST_VALIDATOR_HPP
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "ndnmps/bls-helpers.hpp"
+#include "ndnmps/schema.hpp"
+
+namespace ndn {
+namespace mps {
+
+/**
+ * @brief The validator of BLS-signed command Interests, e.g. from ndnBLSSign with a SignatureInfo
+ *        carrying a timestamp and a nonce.
+ *
+ * An Interest is valid if its KeyLocator is a trusted key of the schema container, its signature verifies,
+ * and it is not a replay: its timestamp is within the grace period of the local clock and later than
+ * the last valid Interest of the key, its sequence number is larger than the last one, and its nonce is not
+ * among the recent nonces of the key. The replay state is only updated by valid Interests.
+ */
+class BLSInterestValidator
+{
+public:
+  explicit
+  BLSInterestValidator(const MultipartySchemaContainer& schemaContainer);
+
+  bool
+  validate(const Interest& interest);
+
+  /**
+   * Validate a burst of Interests. The signatures are checked together with one batched pairing check,
+   * which is bisected only when some of them are invalid, and the replay checks are applied in order,
+   * as if the Interests were validated one by one.
+   * @return whether each Interest is valid.
+   */
+  std::vector<bool>
+  validate(const std::vector<Interest>& interests);
+
+  void
+  clear()
+  {
+    m_records.clear();
+    m_recordIndex.clear();
+    m_evictionFloor = nullopt;
+  }
+
+public:
+  // the fields every Interest must carry and pass
+  bool m_shouldValidateTimestamps = true;
+  bool m_shouldValidateNonces = true;
+  bool m_shouldValidateSeqNums = false;
+  // max difference between the timestamp of an Interest and the local clock
+  time::milliseconds m_timestampGracePeriod = time::seconds(60);
+  // number of the recent nonces remembered per key
+  size_t m_maxNoncesPerKey = 1000;
+  /**
+   * Number of keys whose replay state is kept, the least recently used are dropped beyond it.
+   * Once a record is dropped, keys without a record must carry timestamps later than the dropped one,
+   * so Interests of the dropped key cannot be replayed. This relies on m_shouldValidateTimestamps;
+   * without it, set the limit to at least the number of trusted keys.
+   */
+  size_t m_maxRecords = 1000;
+
+private:
+  struct ReplayRecord
+  {
+    optional<time::system_clock::TimePoint> m_lastTimestamp;
+    optional<uint64_t> m_lastSeqNum;
+    std::set<std::vector<uint8_t>> m_nonces;
+    std::list<std::vector<uint8_t>> m_nonceOrder; // oldest first
+  };
+  using RecordList = std::list<std::pair<Name, ReplayRecord>>;
+
+  /**
+   * @return false if the Interest misses a validated field or replays an earlier Interest of the key.
+   */
+  bool
+  checkReplay(const Name& keyName, const SignatureInfo& info) const;
+
+  void
+  updateRecord(const Name& keyName, const SignatureInfo& info);
+
+private:
+  const MultipartySchemaContainer& m_schemaContainer;
+  RecordList m_records; // most recently used first
+  std::map<Name, RecordList::iterator> m_recordIndex;
+  // the latest timestamp of the dropped records
+  optional<time::system_clock::TimePoint> m_evictionFloor;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_INTEREST_VALIDATOR_HPP
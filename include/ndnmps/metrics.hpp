@@ -0,0 +1,229 @@
+#ifndef NDNMPS_METRICS_HPP
+#define NDNMPS_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common.hpp"
+
+namespace ndn {
+namespace mps {
+
+/**
+ * @brief A counter that can be incremented by multiple threads.
+ *
+ * Increments are dropped while metrics are disabled (see Metrics::setEnabled).
+ */
+class MetricCounter : noncopyable
+{
+public:
+  void
+  increment(uint64_t value = 1);
+
+  uint64_t
+  get() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+  void
+  reset()
+  {
+    m_value.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @brief A latency histogram with log-linear buckets, in the style of HdrHistogram.
+ *
+ * Values below 16 have a bucket each. Every larger power of two is split into 16 buckets,
+ * so a percentile is off by at most 1/16 of the value. Recording is lock-free.
+ */
+class LatencyHistogram : noncopyable
+{
+public:
+  static constexpr size_t SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT;
+
+  struct Snapshot
+  {
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = 0;
+    uint64_t m_max = 0;
+    std::array<uint64_t, BUCKET_COUNT> m_buckets{};
+
+    /**
+     * @param percentile in [0, 100].
+     * @return the upper bound of the bucket holding the percentile, or 0 if nothing is recorded.
+     */
+    uint64_t
+    getPercentile(double percentile) const;
+  };
+
+public:
+  /**
+   * Record a value, in nanoseconds for the histograms of Metrics.
+   * Values are dropped while metrics are disabled.
+   */
+  void
+  record(uint64_t value);
+
+  /**
+   * Record the nanoseconds elapsed since @p begin, for phases spanning asynchronous callbacks.
+   * Nothing is recorded if @p begin is not set, i.e. metrics were disabled when the phase started.
+   */
+  void
+  recordSince(std::chrono::steady_clock::time_point begin);
+
+  Snapshot
+  snapshot() const;
+
+  void
+  reset();
+
+  static size_t
+  getBucketIndex(uint64_t value);
+
+  /**
+   * @return the largest value falling into the bucket.
+   */
+  static uint64_t
+  getBucketUpperBound(size_t index);
+
+private:
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+  std::atomic<uint64_t> m_min{std::numeric_limits<uint64_t>::max()};
+  std::atomic<uint64_t> m_max{0};
+};
+
+/**
+ * @brief The process-wide registry of the counters and latency histograms of the protocol players.
+ *
+ * Metrics are created on first use and live as long as the process, so call sites keep references to them,
+ * e.g. in function-local statics. Metrics are disabled by default; while disabled, counters and histograms
+ * drop updates and ScopedTimer does not read the clock, so the only cost is one relaxed atomic load.
+ *
+ * The histograms of the protocol phases are (values in nanoseconds):
+ *  - initiator.handshake: from sending a sign request to receiving its ACK
+ *  - initiator.pairing: batch verification of the signature pieces
+ *  - initiator.aggregation: combining the fetched pieces into the final signature value
+ *  - signer.parameter_fetch: from requesting the parameter Data to receiving it
+ *  - signer.signing: generation of a signature piece
+ *  - verifier.schema_check, verifier.key_aggregation, verifier.pairing: the steps of BLSVerifier::verify
+ */
+class Metrics : noncopyable
+{
+public:
+  static Metrics&
+  get();
+
+  static bool
+  isEnabled()
+  {
+    return s_isEnabled.load(std::memory_order_relaxed);
+  }
+
+  static void
+  setEnabled(bool isEnabled)
+  {
+    s_isEnabled.store(isEnabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * @return the counter of the name, created if it does not exist.
+   */
+  MetricCounter&
+  counter(const std::string& name);
+
+  /**
+   * @return the histogram of the name, created if it does not exist.
+   */
+  LatencyHistogram&
+  histogram(const std::string& name);
+
+  std::map<std::string, uint64_t>
+  snapshotCounters() const;
+
+  std::map<std::string, LatencyHistogram::Snapshot>
+  snapshotHistograms() const;
+
+  /**
+   * Export a snapshot of all metrics as a JSON object:
+   *   {"counters": {name: value}, "histograms": {name: {"count", "sum", "min", "max", "p50", "p90", "p99", "p999"}}}
+   */
+  std::string
+  toJson() const;
+
+  /**
+   * Reset all metrics to zero. References to them stay valid.
+   */
+  void
+  reset();
+
+private:
+  Metrics() = default;
+
+private:
+  static std::atomic<bool> s_isEnabled;
+  mutable std::mutex m_mutex;
+  std::map<std::string, std::unique_ptr<MetricCounter>> m_counters;
+  std::map<std::string, std::unique_ptr<LatencyHistogram>> m_histograms;
+};
+
+/**
+ * @brief Record the time from construction to stop() or destruction into a histogram, in nanoseconds.
+ *
+ * Nothing is recorded if metrics are disabled when the timer is constructed.
+ */
+class ScopedTimer : noncopyable
+{
+public:
+  explicit
+  ScopedTimer(LatencyHistogram& histogram)
+    : m_histogram(Metrics::isEnabled() ? &histogram : nullptr)
+  {
+    if (m_histogram != nullptr) {
+      m_begin = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedTimer()
+  {
+    stop();
+  }
+
+  /**
+   * Record the elapsed time. Later calls have no effect.
+   */
+  void
+  stop()
+  {
+    if (m_histogram != nullptr) {
+      auto elapsed = std::chrono::steady_clock::now() - m_begin;
+      m_histogram->record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      m_histogram = nullptr;
+    }
+  }
+
+private:
+  LatencyHistogram* m_histogram;
+  std::chrono::steady_clock::time_point m_begin;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_METRICS_HPP
@@ -2,6 +2,7 @@
 #define NDNMPS_MPS_SIGNER_LIST_HPP
 
 #include <ndn-cxx/name.hpp>
+#include <iterator>
 #include <set>
 
 #include "common.hpp"
@@ -78,6 +79,171 @@ public:
 std::ostream&
 operator<<(std::ostream& os, const MpsSignerList& signerList);
 
+/**
+ * @brief A read-only view of an encoded MpsSignerList.
+ *
+ * The view walks the Name elements in the wire encoding instead of decoding them into Name objects.
+ * When created, it computes a hash that does not depend on the order of the names, so different lists
+ * are told apart with one comparison. Equal hashes are confirmed by comparing the encoded names,
+ * in O(n) when both lists are in sorted wire order.
+ */
+class MpsSignerListView
+{
+public:
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Block;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Block*;
+    using reference = Block;
+
+    const_iterator() = default;
+
+    /**
+     * @return the Name element. The Block shares the buffer of the signer list.
+     */
+    Block
+    operator*() const;
+
+    const_iterator&
+    operator++();
+
+    const_iterator
+    operator++(int);
+
+    bool
+    operator==(const const_iterator& other) const
+    {
+      return m_pos == other.m_pos;
+    }
+
+    bool
+    operator!=(const const_iterator& other) const
+    {
+      return m_pos != other.m_pos;
+    }
+
+  private:
+    const_iterator(const MpsSignerListView* view, Buffer::const_iterator pos);
+
+  private:
+    const MpsSignerListView* m_view = nullptr;
+    Buffer::const_iterator m_pos;
+
+    friend class MpsSignerListView;
+  };
+
+public:
+  MpsSignerListView() = default;
+
+  /**
+   * Create the view over the wire encoding.
+   * @throw ndn::tlv::Error if the block is not a well-formed MpsSignerList.
+   */
+  explicit
+  MpsSignerListView(const Block& wire);
+
+  const_iterator
+  begin() const
+  {
+    return const_iterator(this, m_wire.value_begin());
+  }
+
+  const_iterator
+  end() const
+  {
+    return const_iterator(this, m_wire.value_end());
+  }
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  bool
+  empty() const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * @return the hash of the signer set, which does not depend on the order of the names.
+   */
+  uint64_t
+  getHash() const
+  {
+    return m_hash;
+  }
+
+  const Block&
+  wireEncode() const
+  {
+    return m_wire;
+  }
+
+  /**
+   * Decode the names into a MpsSignerList.
+   */
+  MpsSignerList
+  toSignerList() const;
+
+  /**
+   * Compare the signer lists. The comparison returns true if both sides have the same names.
+   */
+  bool
+  operator==(const MpsSignerListView& rhs) const;
+
+  bool
+  operator!=(const MpsSignerListView& rhs) const
+  {
+    return !operator==(rhs);
+  }
+
+private:
+  Block m_wire;
+  size_t m_size = 0;
+  uint64_t m_hash = 0;
+  bool m_isSorted = true;
+};
+
+/**
+ * Compare a name with an encoded Name element in the NDN canonical order, without decoding the element.
+ * @return negative, zero, or positive if the name is before, the same as, or after the element.
+ * @throw ndn::tlv::Error if the element is malformed.
+ */
+int
+compareName(const Name& name, const Block& nameWire);
+
+/**
+ * @brief Orders names in the NDN canonical order, and compares them with encoded Name elements in place,
+ *        so a map keyed by names can be looked up with the elements of a MpsSignerListView.
+ */
+struct NameWireCompare
+{
+  using is_transparent = void;
+
+  bool
+  operator()(const Name& lhs, const Name& rhs) const
+  {
+    return lhs < rhs;
+  }
+
+  bool
+  operator()(const Name& lhs, const Block& rhs) const
+  {
+    return compareName(lhs, rhs) < 0;
+  }
+
+  bool
+  operator()(const Block& lhs, const Name& rhs) const
+  {
+    return compareName(rhs, lhs) > 0;
+  }
+};
+
 }  // namespace mps
 }  // namespace ndn
 
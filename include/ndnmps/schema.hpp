@@ -4,8 +4,10 @@
 #include <ndn-cxx/name.hpp>
 #include <set>
 #include <list>
+#include <tuple>
 #include "mps-signer-list.hpp"
 #include "bls-helpers.hpp"
+#include "trusted-key-roster.hpp"
 
 namespace ndn {
 namespace mps {
@@ -33,6 +35,14 @@ public:
   bool
   match(const Name& name) const;
 
+  /**
+   * Wildcard match the name in the wire encoding, without decoding it into a Name.
+   * @param nameWire the Name TLV to be matched
+   * @return true if the name can be matched.
+   */
+  bool
+  match(const Block& nameWire) const;
+
   std::string
   toUri() const {
     return m_name.toUri();
@@ -129,22 +139,88 @@ public:
    */
   bool
   passSchema(const std::vector<Name>& signers) const;
+
+  bool
+  passSchema(const MpsSignerListView& signers) const;
 };
 
 class MultipartySchemaContainer
 {
 public:
   std::list<MultipartySchema> m_schemas;
-  std::map<Name, BLSPublicKey> m_trustedIds; // keyName, keyBits
-  mutable std::set<Name> m_unavailableSigners; // a temporary state showing which signers are unavailable
+  std::map<Name, BLSPublicKey, NameWireCompare> m_trustedIds; // keyName, keyBits
+  std::shared_ptr<TrustedKeyRoster> m_roster; // trusted keys loaded from a roster file
 
 public:
+  /**
+   * Load the trusted keys from a binary roster file (see TrustedKeyRoster for the format).
+   * The roster is memory-mapped and replaces the previously loaded one, if any.
+   * Keys in m_trustedIds are still trusted. Lookups may run from multiple threads, but not together
+   * with this call or other changes to the container.
+   * @param rosterFile the roster file name.
+   * @param shouldVerifyPops whether to check the proofs of possession of all the keys on load, which costs
+   *        one batched pairing check over the whole roster. Skip it only for a roster from a trusted source.
+   * @throw std::runtime_error if the file is not a valid roster or a proof of possession is invalid.
+   */
   void
-  loadTrustedIds(const std::string& fileOrConfigStr);
+  loadTrustedIds(const std::string& rosterFile, bool shouldVerifyPops = true);
+
+  /**
+   * @brief Import signer certificates into m_trustedIds after checking their proofs of possession.
+   *
+   * The certificates are the self-signed ones generated by genSelfSignedCertificate, whose BLS signatures
+   * serve as the proofs of possession. The signatures of all certificates are verified together
+   * with one batched pairing check, which is bisected only when some of them are invalid.
+   * @param certs the self-signed certificates of the signers.
+   * @return the names of the rejected certificates.
+   */
+  std::vector<Name>
+  importCertificates(const std::vector<security::Certificate>& certs);
+
+  /**
+   * @return true if the key is in m_trustedIds or in the loaded roster.
+   */
+  bool
+  isTrustedKey(const Name& keyName) const;
+
+  /**
+   * @return the public key of a trusted key.
+   * @throw std::runtime_error if the key is not trusted.
+   */
+  const BLSPublicKey&
+  getTrustedKey(const Name& keyName) const;
+
+  /**
+   * Look up a trusted key by its encoded Name element, e.g. of a MpsSignerListView, without decoding it.
+   * @return the public key, or nullptr if the key is not trusted or the element is malformed.
+   */
+  const BLSPublicKey*
+  findTrustedKey(const Block& keyNameWire) const;
+
+  bool
+  isTrustedKey(const Block& keyNameWire) const
+  {
+    return findTrustedKey(keyNameWire) != nullptr;
+  }
+
+  /**
+   * @throw std::runtime_error if the key is not trusted.
+   */
+  const BLSPublicKey&
+  getTrustedKey(const Block& keyNameWire) const;
 
   bool
   passSchema(const Name& packetName, const MpsSignerList& signers) const;
 
+  /**
+   * Check the encoded signer list against the trusted keys and the schema of the packet.
+   * @param pubKeys if not null, set to the public keys of the signers in the order of the list when
+   *                the check passes, so they need not be looked up again for the aggregation.
+   */
+  bool
+  passSchema(const Name& packetName, const MpsSignerListView& signers,
+             std::vector<const BLSPublicKey*>* pubKeys = nullptr) const;
+
   /**
    * the the minimum possible signer set from the available signing party
    * so the aggregater may be able to reduce the length of signer list
@@ -153,23 +229,11 @@ public:
   MpsSignerList
   getAvailableSigners(const MultipartySchema& schema) const;
 
-  /**
-   * @brief When a signer is unavailable. find a replacement.
-   * @param signers The existing list and will be renewed.
-   * @param unavailableKey The key name of the unavailable signer.
-   * @param schema The schema.
-   * @return nonempty MpsSignerList and a diff name list if there is an available replacement of the unavailable key.
-   */
-  std::tuple<MpsSignerList, std::vector<Name>>
-  replaceSigner(const MpsSignerList& signers, const Name& unavailableKey, const MultipartySchema& schema) const;
-
   BLSPublicKey
   aggregateKey(const MpsSignerList& signers) const;
 
-  void
-  resetCachedUnavailableSigners() const {
-    m_unavailableSigners.clear();
-  }
+  BLSPublicKey
+  aggregateKey(const MpsSignerListView& signers) const;
 
 private:
   /**
@@ -179,9 +243,74 @@ private:
    */
   std::vector<Name>
   getMatchedKeys(const WildCardName& pattern) const;
+};
+
+/**
+ * @brief The signer selection state of one multi-party signing session.
+ *
+ * The trusted IDs are matched against the schema only once, when the session is created.
+ * For each pattern, the session keeps the sorted candidate keys and a cursor to the first candidate
+ * that has not been tried, so replacing signers only walks forward from the cursor.
+ * Unavailable signers are recorded in the session and the container is left untouched.
+ */
+class SignerSelectionSession
+{
+public:
+  /**
+   * Match the trusted IDs of the container and select the initial signers of the schema.
+   * @param container the schema container holding the trusted IDs.
+   * @param schema the schema to be satisfied.
+   * @throw std::runtime_error if the container does not have sufficient keys for the schema.
+   */
+  SignerSelectionSession(const MultipartySchemaContainer& container, const MultipartySchema& schema);
 
-  std::tuple<bool, Name>
-  findANewKeyForPattern(const std::set<Name>& existingSigners, WildCardName pattern) const;
+  /**
+   * @return the currently selected signers.
+   */
+  MpsSignerList
+  getSigners() const;
+
+  /**
+   * @brief Replace several unavailable signers in one step.
+   * @param unavailableKeys The key names of the unavailable signers.
+   * @return nonempty MpsSignerList and a diff name list if there are available replacements of the unavailable keys.
+   */
+  std::tuple<MpsSignerList, std::vector<Name>>
+  replaceSigners(const std::vector<Name>& unavailableKeys);
+
+private:
+  struct PatternState
+  {
+    WildCardName m_pattern;
+    std::vector<Name> m_candidates; // matched trusted keys, sorted
+    size_t m_next = 0; // the first candidate that has not been tried
+    size_t m_selectedCount = 0; // number of selected keys matching the pattern
+  };
+
+  void
+  select(const Name& keyName);
+
+  void
+  deselect(const Name& keyName);
+
+  bool
+  selectNextCandidate(PatternState& state, std::vector<Name>& added);
+
+  bool
+  fillRequiredSigners(std::vector<Name>& added);
+
+  bool
+  fillOptionalSigners(std::vector<Name>& added);
+
+  size_t
+  countOptionalSigners() const;
+
+private:
+  std::vector<PatternState> m_required;
+  std::vector<PatternState> m_optional;
+  size_t m_minOptionalSigners;
+  std::set<Name> m_selected;
+  std::set<Name> m_unavailable;
 };
 
 }  // namespace mps
@@ -6,8 +6,13 @@
 #include "ndnmps/schema.hpp"
 #include "ndnmps/crypto-helpers.hpp"
 #include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <array>
+#include <deque>
 #include <iostream>
+#include <list>
 #include <map>
+#include <set>
 #include <tuple>
 
 namespace ndn {
@@ -15,6 +20,7 @@ namespace mps {
 
 using VerifyToBeSignedCallback = function<bool(const Data&)>;
 using VerifySignRequestCallback = function<bool(const Interest&)>;
+struct SignRequestState;
 
 /**
  * The signer class class that handles functionality in the multi-signing protocol.
@@ -24,6 +30,7 @@ class BLSSigner
 {
 private:
   Face& m_face;
+  Scheduler m_scheduler;
   KeyChain& m_keyChain;
   VerifyToBeSignedCallback m_verifyToBeSignedCallback;
   VerifySignRequestCallback m_verifySignRequestCallback;
@@ -34,8 +41,75 @@ private:
   BLSPublicKey m_pk;
   Name m_keyName;
 
+  struct ResumptionTicket
+  {
+    std::array<uint8_t, 32> m_secret;
+    time::steady_clock::TimePoint m_expiry;
+    uint64_t m_remainingRequests;
+    uint64_t m_lastCounter; // the counter of a resumed request must be larger than this
+  };
+  std::map<uint64_t, ResumptionTicket> m_tickets;
+
+  // request ID, state of the request until its final result is fetched or it expires
+  std::map<uint64_t, std::shared_ptr<SignRequestState>> m_requests;
+  size_t m_requestMemory = 0; // estimated octets held by m_requests
+
+  struct TokenBucket
+  {
+    double m_tokens;
+    time::steady_clock::TimePoint m_lastUpdate;
+
+    /**
+     * Refill the bucket up to burst at rate tokens per second, and take a token if there is one.
+     */
+    bool
+    take(double rate, double burst, const time::steady_clock::TimePoint& now);
+  };
+  TokenBucket m_unverifiedBucket; // shared by all the requests before their verification
+  using TokenBucketList = std::list<std::pair<Name, TokenBucket>>;
+  TokenBucketList m_tokenBuckets; // verified initiator key names, most recently used first
+  std::map<Name, TokenBucketList::iterator> m_tokenBucketIndex;
+
+  using NonceKey = std::pair<Name, std::vector<uint8_t>>; // initiator key name, nonce of the signed Interest
+  std::set<NonceKey> m_seenNonces;
+  std::deque<std::pair<time::steady_clock::TimePoint, NonceKey>> m_nonceExpiry; // oldest first
+
 public:
   const Name m_prefix;
+  // pregenerated ECDH key pairs for the handshakes, generated per request when not set
+  std::shared_ptr<ECDHKeyPool> m_ecdhKeyPool;
+  // lifetime of the resumption tickets issued after full handshakes, zero to disable session resumption
+  time::milliseconds m_ticketLifetime = time::milliseconds(0);
+  // number of requests that can resume the session with one ticket
+  uint64_t m_ticketRequestBudget = 128;
+  // number of live resumption tickets, beyond which the oldest one is dropped when a new one is issued
+  size_t m_maxTickets = 1024;
+  /**
+   * Limits of the ongoing requests. New requests beyond them are answered with ReplyCode::Unavailable,
+   * and a request is dropped m_requestLifetime after its ACK, whether or not its result has been fetched.
+   */
+  size_t m_maxRequests = 1024;
+  size_t m_maxRequestMemory = 4 * 1024 * 1024;
+  time::milliseconds m_requestLifetime = time::seconds(30);
+  /**
+   * Requests per second, and burst, admitted to the verification from all the initiators together.
+   * Zero rate to disable.
+   */
+  double m_unverifiedRequestRate = 1000;
+  double m_unverifiedRequestBurst = 2000;
+  /**
+   * Requests per second, and burst, allowed from each initiator key. The limit is applied once the request
+   * is verified, so a forged KeyLocator cannot use up the budget of another initiator. Zero rate to disable.
+   */
+  double m_requestRate = 100;
+  double m_requestBurst = 200;
+  /**
+   * Sign requests must carry a timestamp within this window of the local clock and a nonce, which is
+   * remembered for twice as long, so a captured request cannot be replayed. Zero to disable the checks.
+   */
+  time::milliseconds m_replayWindow = time::seconds(60);
+  // nonces remembered at most, beyond which new signed requests are dropped
+  size_t m_maxSeenNonces = 65536;
 
 public:
   /**
@@ -66,9 +140,110 @@ public:
     return m_keyName;
   }
 
+  /**
+   * Replace the generated key pair, e.g. with a key share of a threshold group from ndnBLSDealKeyShares.
+   * getPublicKey() then returns the public key of the share, which verifies the signature pieces of this signer.
+   */
+  void
+  setSecretKey(const BLSSecretKey& sk);
+
+  size_t
+  getRequestCount() const
+  {
+    return m_requests.size();
+  }
+
+  size_t
+  getTicketCount() const
+  {
+    return m_tickets.size();
+  }
+
+  /**
+   * @return the estimated memory held by the ongoing requests, in octets.
+   */
+  size_t
+  getRequestMemory() const
+  {
+    return m_requestMemory;
+  }
+
 private:
+  /**
+   * Admit a sign request in stages of increasing cost: syntactic checks, the rate limit shared by unverified
+   * requests, the replay window, the verification callback, and the rate limit of the initiator.
+   * Only admitted requests reach the key exchange. Requests failing the stages before verification
+   * are dropped without an ACK, and the rejected ones get an ACK from putRejectionAck.
+   */
   void
   onSignRequest(const Interest&);
+
+  /**
+   * Answer a rejected sign request. The ACK is signed with a SHA-256 digest rather than the BLS key,
+   * so a rejection, e.g. of a forged request, costs no BLS signature.
+   */
+  void
+  putRejectionAck(const Interest& interest, ReplyCode code, uint64_t traceId);
+
+  /**
+   * Take a token from the bucket of the verified initiator. The buckets of the least recently seen
+   * initiators are dropped beyond a fixed number of them.
+   * @return false if the initiator exceeds m_requestRate.
+   */
+  bool
+  takeRequestToken(const Name& initiatorKeyName);
+
+  /**
+   * @return false if the signed request misses its timestamp or nonce, its timestamp is out of m_replayWindow,
+   *         or its nonce has been seen.
+   */
+  bool
+  isFreshRequest(const SignatureInfo& info) const;
+
+  /**
+   * Remember the nonce of a verified request, so that forged requests cannot fill the cache.
+   * @return false if the cache is full.
+   */
+  bool
+  rememberNonce(const SignatureInfo& info);
+
+  /**
+   * Fetch the payload Data that the initiator encrypts once per session, and decrypt it with the content key.
+   * @param payloadKey the PayloadKey block from the parameter Data.
+   * @throw std::runtime_error or ndn::tlv::Error if the PayloadKey block is malformed.
+   */
+  void
+  fetchPayloadData(const Block& payloadKey, std::shared_ptr<SignRequestState> statePtr);
+
+  void
+  onUnsignedData(const Data& unsignedData, std::shared_ptr<SignRequestState> statePtr);
+
+  /**
+   * Drop the request, unregistering its result prefix and cancelling its expiry.
+   */
+  void
+  removeRequest(uint64_t requestId);
+
+  /**
+   * Update m_requestMemory after the state of the request has grown or shrunk.
+   */
+  void
+  updateRequestMemory(SignRequestState& state);
+
+  /**
+   * Store a resumption ticket for the resumption secret, dropping the expired tickets, and the oldest one
+   * if m_maxTickets tickets are live.
+   * @return the Ticket block to be sent to the initiator in the encrypted ACK.
+   */
+  Block
+  issueTicket(const uint8_t* resumptionSecret);
+
+  /**
+   * Check a resumed request against its ticket and derive the AES and HMAC keys (48 octets) of the request.
+   * @return false if the ticket is unknown, expired, out of budget, or the counter is replayed.
+   */
+  bool
+  useTicket(uint64_t ticketId, uint64_t ticketCounter, uint8_t* keys);
 };
 
 }  // namespace mps
@@ -0,0 +1,157 @@
+#ifndef NDNMPS_TRACER_HPP
+#define NDNMPS_TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+namespace ndn {
+namespace mps {
+
+/**
+ * @brief The process-wide collector of the span events of signing sessions.
+ *
+ * When tracing is enabled, the initiator gives each session a random trace ID, carried in the TraceId
+ * element of the sign requests and echoed by the signers in their ACK and result Data. Every player
+ * records its spans under the trace ID of the session, on a track named after itself (e.g. the signer prefix),
+ * so a trace shows which signer, phase, or retry is on the critical path of the session.
+ *
+ * The events are written in the Chrome trace event format, which chrome://tracing and Perfetto load.
+ * Each session is shown as a process and each player as a thread of it.
+ */
+class Tracer : noncopyable
+{
+public:
+  struct Event
+  {
+    std::string m_name;
+    uint64_t m_traceId;
+    std::string m_track;
+    char m_phase; // 'X' for a complete span, 'i' for an instant event
+    int64_t m_timestamp; // microseconds of the steady clock
+    int64_t m_duration; // microseconds, complete spans only
+    std::map<std::string, std::string> m_args;
+  };
+
+public:
+  static Tracer&
+  get();
+
+  static bool
+  isEnabled()
+  {
+    return s_isEnabled.load(std::memory_order_relaxed);
+  }
+
+  static void
+  setEnabled(bool isEnabled)
+  {
+    s_isEnabled.store(isEnabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * Generate a trace ID for a new session.
+   * @return a random nonzero ID if tracing is enabled, zero otherwise.
+   */
+  static uint64_t
+  newTraceId();
+
+  void
+  addCompleteEvent(const std::string& name, uint64_t traceId, const std::string& track,
+                   std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end,
+                   std::map<std::string, std::string> args = {});
+
+  void
+  addInstantEvent(const std::string& name, uint64_t traceId, const std::string& track,
+                  std::map<std::string, std::string> args = {});
+
+  std::vector<Event>
+  getEvents() const;
+
+  void
+  clear();
+
+  /**
+   * Write the events as a JSON object in the Chrome trace event format.
+   */
+  void
+  writeChromeTrace(std::ostream& os) const;
+
+  /**
+   * @throw std::runtime_error if the file cannot be written.
+   */
+  void
+  writeChromeTrace(const std::string& fileName) const;
+
+public:
+  // events beyond the limit are dropped
+  size_t m_maxEvents = 1 << 20;
+
+private:
+  Tracer() = default;
+
+  void
+  addEvent(Event&& event);
+
+private:
+  static std::atomic<bool> s_isEnabled;
+  mutable std::mutex m_mutex;
+  std::vector<Event> m_events;
+};
+
+/**
+ * @brief A span of a traced session, recorded as a complete event when it ends.
+ *
+ * The span is inactive, and costs nothing, if tracing is disabled or the trace ID is zero.
+ * A span that is not ended explicitly ends when it is destroyed, so spans kept in the state of
+ * an abandoned request still show up in the trace.
+ */
+class TraceSpan : noncopyable
+{
+public:
+  TraceSpan() = default;
+
+  TraceSpan(std::string name, uint64_t traceId, std::string track);
+
+  TraceSpan(TraceSpan&& other);
+
+  TraceSpan&
+  operator=(TraceSpan&& other);
+
+  ~TraceSpan();
+
+  bool
+  isActive() const
+  {
+    return m_traceId != 0;
+  }
+
+  /**
+   * Record the span. Later calls have no effect.
+   */
+  void
+  end(std::map<std::string, std::string> args = {});
+
+private:
+  std::string m_name;
+  uint64_t m_traceId = 0;
+  std::string m_track;
+  std::chrono::steady_clock::time_point m_begin;
+};
+
+/**
+ * Read the TraceId element of a sign request, ACK, or result.
+ * @return the trace ID, or zero if the block has no well-formed TraceId element.
+ */
+uint64_t
+readTraceId(const Block& block);
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_TRACER_HPP
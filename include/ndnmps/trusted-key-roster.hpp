@@ -0,0 +1,181 @@
+#ifndef NDNMPS_TRUSTED_KEY_ROSTER_HPP
+#define NDNMPS_TRUSTED_KEY_ROSTER_HPP
+
+#include "bls-helpers.hpp"
+#include "mps-signer-list.hpp"
+#include <ndn-cxx/name.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ndn {
+namespace mps {
+
+/**
+ * @brief A read-only store of trusted BLS public keys backed by a binary roster file.
+ *
+ * The roster file format (integers in network byte order):
+ *   Header: "NDNMPSRS" (8 octets) | format version (4 octets) | record count (4 octets) | roster version (8 octets)
+ *   Record: key name (Name TLV) | compressed public key (48 octets) | proof of possession (96 octets)
+ *
+ * The file is memory-mapped. Key names are indexed when the roster is opened, while the public keys
+ * are only deserialized when they are used for the first time. The lazy decoding is guarded per key,
+ * so a roster can be shared by threads verifying at the same time.
+ *
+ * A roster is identified by the SHA-256 digest of the file, so a signer list can refer to the signers
+ * by their indexes in the roster (see encodeSignerList) instead of listing the full key names:
+ *   MpsRosterSignerList = RosterVersion RosterDigest (SignerBitmap / SignerIndexDeltas)
+ * SignerBitmap sets the (i % 8)-th most significant bit of the (i / 8)-th octet for the key at index i.
+ * SignerIndexDeltas is a sequence of VAR-NUMBERs: the first index, then the gaps between the sorted indexes.
+ */
+class TrustedKeyRoster : noncopyable
+{
+public:
+  struct Entry
+  {
+    Name m_keyName;
+    BLSPublicKey m_publicKey;
+    BLSSignature m_proofOfPossession;
+  };
+
+  static const size_t npos;
+
+  /**
+   * Write a roster file. The entries are sorted by key name in the file.
+   * @param fileName the file to be written.
+   * @param entries the trusted keys with their proofs of possession.
+   * @param rosterVersion the version of this roster.
+   * @throw std::runtime_error if the file cannot be written.
+   */
+  static void
+  writeRoster(const std::string& fileName, std::vector<Entry> entries, uint64_t rosterVersion = 0);
+
+  /**
+   * Open and index a roster file.
+   * @param fileName the roster file.
+   * @throw std::runtime_error if the file cannot be mapped or is not a valid roster.
+   */
+  explicit
+  TrustedKeyRoster(const std::string& fileName);
+
+  ~TrustedKeyRoster();
+
+  size_t
+  size() const
+  {
+    return m_keyNames.size();
+  }
+
+  uint64_t
+  getVersion() const
+  {
+    return m_version;
+  }
+
+  /**
+   * @return the key names in the roster, sorted in the NDN canonical order.
+   */
+  const std::vector<Name>&
+  getKeyNames() const
+  {
+    return m_keyNames;
+  }
+
+  /**
+   * @return the index of the key, or npos if the key is not in the roster.
+   */
+  size_t
+  find(const Name& keyName) const;
+
+  /**
+   * Find the key of an encoded Name element, e.g. of a MpsSignerListView, without decoding it.
+   * @return the index of the key, or npos if the key is not in the roster.
+   * @throw ndn::tlv::Error if the element is malformed.
+   */
+  size_t
+  find(const Block& keyNameWire) const;
+
+  /**
+   * Get the public key at the index, deserializing it on the first access.
+   * @throw std::runtime_error if the public key cannot be deserialized.
+   */
+  const BLSPublicKey&
+  getPublicKey(size_t index) const;
+
+  /**
+   * Get the proof of possession of the public key at the index.
+   * @throw std::runtime_error if the signature cannot be deserialized.
+   */
+  BLSSignature
+  getProofOfPossession(size_t index) const;
+
+  /**
+   * Check the proofs of possession of all the keys, so that no rogue key can cancel out the others
+   * in an aggregate. They are verified together with one batched pairing check, which is bisected
+   * only when some of them are invalid.
+   * @return the indexes of the keys whose proofs of possession are invalid, in increasing order.
+   */
+  std::vector<size_t>
+  findInvalidProofsOfPossession() const;
+
+  /**
+   * @return the SHA-256 digest of the roster file, computed on the first call.
+   */
+  const Buffer&
+  getDigest() const;
+
+  /**
+   * Encode the signer list as indexes into this roster, using the shorter one of the bitmap
+   * and the delta-coded indexes.
+   * @return the MpsRosterSignerList block
+   * @throw std::runtime_error if a signer is not in this roster.
+   */
+  Block
+  encodeSignerList(const MpsSignerList& signers) const;
+
+  /**
+   * Decode the roster indexes of the signers from a MpsRosterSignerList block.
+   * @return the strictly increasing indexes of the signers, all within the roster.
+   * @throw ndn::tlv::Error if the block is malformed, refers to another roster, or has an index
+   *        out of the roster range.
+   */
+  std::vector<size_t>
+  decodeSignerIndexes(const Block& wire) const;
+
+  /**
+   * Decode the signer names from a MpsRosterSignerList block.
+   * @throw ndn::tlv::Error if the block is malformed or refers to another roster.
+   */
+  MpsSignerList
+  decodeSignerList(const Block& wire) const;
+
+  /**
+   * Get the signer names of the roster indexes, e.g. from decodeSignerIndexes.
+   * @throw std::out_of_range if an index is out of the roster range.
+   */
+  MpsSignerList
+  getSignerList(const std::vector<size_t>& indexes) const;
+
+  /**
+   * Aggregate the public keys at the roster indexes.
+   * @throw std::runtime_error if the indexes are empty.
+   */
+  BLSPublicKey
+  aggregateKey(const std::vector<size_t>& indexes) const;
+
+private:
+  const uint8_t* m_base = nullptr;
+  size_t m_mappedSize = 0;
+  uint64_t m_version = 0;
+  std::vector<Name> m_keyNames;
+  std::vector<size_t> m_keyOffsets; // offset of the public key of each record
+  mutable std::vector<BLSPublicKey> m_publicKeys; // each written once, under its flag in m_decodeFlags
+  std::unique_ptr<std::once_flag[]> m_decodeFlags;
+  mutable Buffer m_digest;
+  mutable std::once_flag m_digestFlag;
+};
+
+}  // namespace mps
+}  // namespace ndn
+
+#endif  // NDNMPS_TRUSTED_KEY_ROSTER_HPP
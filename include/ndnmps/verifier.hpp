@@ -2,11 +2,13 @@
 #define NDNMPS_VERIFIER_HPP
 
 #include <iostream>
+#include <list>
 #include <map>
 #include <tuple>
 #include <ndn-cxx/face.hpp>
 
 #include "ndnmps/bls-helpers.hpp"
+#include "ndnmps/data-bundle.hpp"
 #include "ndnmps/mps-signer-list.hpp"
 #include "ndnmps/schema.hpp"
 
@@ -21,11 +23,21 @@ typedef function<void(bool)> VerifyFinishCallback;
  */
 class BLSVerifier {
 private:
+  struct SignerListCacheEntry
+  {
+    MpsSignerListView m_signers;
+    std::vector<BLSPublicKey> m_keys; // the signer keys the aggregate was made of, checked on every hit
+    BLSPublicKey m_aggregateKey;
+  };
+
   Face& m_face;
+  std::list<SignerListCacheEntry> m_signerListCache; // most recently used first
 
 public:
   // known schemas and identities
   MultipartySchemaContainer m_schemaContainer;
+  // max number of signer lists whose aggregated keys are cached
+  size_t m_signerListCacheLimit = 64;
 
 public:
   /**
@@ -34,11 +46,55 @@ public:
    */
   BLSVerifier(Face& face);
 
+  /**
+   * Verify a packet signed by the signer list in the signature info Data.
+   * Every call is counted in verifier.verifications, and every invalid packet in verifier.failures.
+   */
   bool
   verify(const Data& data, const Data& signatureInfoData);
 
+  /**
+   * Verify a packet whose KeyLocator is a trusted key, e.g. the group key of a threshold group.
+   * No signature info Data or key aggregation is needed, but the key must pass the schema of the packet.
+   */
+  bool
+  verify(const Data& data);
+
   void
   asyncVerify(const Data& data, const VerifyFinishCallback& callback);
+
+  /**
+   * Verify all packets of a bundle with one multi-pairing.
+   * The signer of each packet must be a trusted key that passes the schema of the packet name.
+   * No signature info Data is needed, as each packet names its signer in its KeyLocator.
+   */
+  bool
+  verifyBundle(const BLSDataBundle& bundle);
+
+  /**
+   * Drop the cached aggregated keys.
+   * Calling this is not needed when a trusted key is replaced, as an entry made of a replaced key is a miss.
+   */
+  void
+  clearSignerListCache()
+  {
+    m_signerListCache.clear();
+  }
+
+private:
+  bool
+  verifyWithSignerList(const Data& data, const Data& signatureInfoData);
+
+  bool
+  verifyWithKeyLocator(const Data& data);
+
+  /**
+   * Get the aggregated key of the signers, from the cache if the same signer set has been seen recently
+   * with the same keys.
+   * @param pubKeys the public keys of the signers, from the trust check of the signers.
+   */
+  BLSPublicKey
+  getAggregateKey(const MpsSignerListView& signers, const std::vector<const BLSPublicKey*>& pubKeys);
 };
 
 }  // namespace mps
@@ -1,5 +1,13 @@
 #include "ndnmps/bls-helpers.hpp"
+#include "ndnmps/metrics.hpp"
 #include <ndn-cxx/util/random.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <thread>
 
 namespace ndn {
 namespace mps {
@@ -21,6 +29,156 @@ ndnBLSInit()
   }
 }
 
+namespace {
+
+struct SigningMetrics
+{
+  MetricCounter& m_signatures = Metrics::get().counter("bls.signatures");
+  MetricCounter& m_signatureHits = Metrics::get().counter("bls.signature_cache_hits");
+  MetricCounter& m_hashHits = Metrics::get().counter("bls.hash_cache_hits");
+  MetricCounter& m_misses = Metrics::get().counter("bls.signature_cache_misses");
+};
+
+SigningMetrics&
+metrics()
+{
+  static SigningMetrics metrics;
+  return metrics;
+}
+
+/**
+ * A map of bounded size that drops the least recently used entry beyond its capacity.
+ */
+class LruCache
+{
+public:
+  bool
+  find(const std::string& key, BLSSignature& value)
+  {
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return false;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    value = it->second->second;
+    return true;
+  }
+
+  void
+  insert(const std::string& key, const BLSSignature& value, size_t capacity)
+  {
+    if (m_index.count(key) > 0) {
+      return;
+    }
+    m_entries.emplace_front(key, value);
+    m_index.emplace(key, m_entries.begin());
+    shrink(capacity);
+  }
+
+  void
+  shrink(size_t capacity)
+  {
+    while (m_entries.size() > capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+  }
+
+private:
+  using EntryList = std::list<std::pair<std::string, BLSSignature>>;
+  EntryList m_entries; // most recently used first
+  std::map<std::string, EntryList::iterator> m_index;
+};
+
+/**
+ * The process-wide caches of ndnGenBLSSignature, shared by all the signers of the process.
+ * The message hashes are keyed by the SHA-256 digest of the signed portion, and the signatures
+ * by the SHA-256 digest of the secret key and that digest, so no secret key is kept in the cache.
+ */
+struct SignatureCache
+{
+  // read without the lock, so signing with the caches disabled never waits for it
+  std::atomic<size_t> m_capacity{0};
+  std::mutex m_mutex; // guards the caches, never held during curve operations
+  LruCache m_hashes; // G2 points of the messages
+  LruCache m_signatures;
+};
+
+SignatureCache&
+getSignatureCache()
+{
+  static SignatureCache cache;
+  return cache;
+}
+
+} // namespace
+
+void
+ndnBLSSetSignatureCacheCapacity(size_t capacity)
+{
+  auto& cache = getSignatureCache();
+  std::lock_guard<std::mutex> lock(cache.m_mutex);
+  cache.m_capacity.store(capacity, std::memory_order_relaxed);
+  cache.m_hashes.shrink(capacity);
+  cache.m_signatures.shrink(capacity);
+}
+
+/**
+ * Sign the message, looking up and filling the caches if they are enabled.
+ */
+static void
+signMessage(BLSSignature& sig, const BLSSecretKey& signingKey, const uint8_t* message, size_t messageSize)
+{
+  metrics().m_signatures.increment();
+  auto& cache = getSignatureCache();
+  if (cache.m_capacity.load(std::memory_order_relaxed) == 0) {
+    blsSign(&sig, &signingKey, message, messageSize);
+    return;
+  }
+
+  auto digest = util::Sha256::computeDigest(message, messageSize);
+  std::string hashKey(reinterpret_cast<const char*>(digest->data()), digest->size());
+  std::string signatureKey;
+  {
+    uint8_t skBuf[64];
+    auto skSize = blsSecretKeySerialize(skBuf, sizeof(skBuf), &signingKey);
+    util::Sha256 hasher;
+    hasher.update(skBuf, skSize);
+    hasher.update(digest->data(), digest->size());
+    std::fill(skBuf, skBuf + sizeof(skBuf), 0);
+    auto keyDigest = hasher.computeDigest();
+    signatureKey.assign(reinterpret_cast<const char*>(keyDigest->data()), keyDigest->size());
+  }
+
+  BLSSignature hashedMessage;
+  bool hasHash = false;
+  {
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+    if (cache.m_signatures.find(signatureKey, sig)) {
+      metrics().m_signatureHits.increment();
+      return;
+    }
+    hasHash = cache.m_hashes.find(hashKey, hashedMessage);
+  }
+
+  if (hasHash) {
+    metrics().m_hashHits.increment();
+  }
+  else {
+    metrics().m_misses.increment();
+    // the map used by blsSign, which hashes into G2 in the BLS_ETH mode
+    if (blsHashToSignature(&hashedMessage, message, messageSize) != 0) {
+      NDN_THROW(std::runtime_error("Fail to hash the message to the curve"));
+    }
+  }
+  mclBnG2_mulCT(&sig.v, &hashedMessage.v, &signingKey.v);
+
+  std::lock_guard<std::mutex> lock(cache.m_mutex);
+  auto capacity = cache.m_capacity.load(std::memory_order_relaxed);
+  cache.m_hashes.insert(hashKey, hashedMessage, capacity);
+  cache.m_signatures.insert(signatureKey, sig, capacity);
+}
+
 Buffer
 ndnGenBLSSignature(const BLSSecretKey& signingKey, const Data& dataWithInfo)
 {
@@ -28,7 +186,7 @@ ndnGenBLSSignature(const BLSSecretKey& signingKey, const Data& dataWithInfo)
   {
     EncodingBuffer encoder;
     dataWithInfo.wireEncode(encoder, true);
-    blsSign(&sig, &signingKey, encoder.buf(), encoder.size());
+    signMessage(sig, signingKey, encoder.buf(), encoder.size());
   }
   auto sigSize = blsSignatureSerialize(encodingBuf, sizeof(encodingBuf), &sig);
   return Buffer(encodingBuf, sigSize);
@@ -66,7 +224,7 @@ ndnGenBLSSignature(const BLSSecretKey& signingKey, const Interest& interest)
     for (const auto& bufPiece : discontiguousBuf) {
       contiguousBuf.insert(contiguousBuf.end(), bufPiece.first, bufPiece.first + bufPiece.second);
     }
-    blsSign(&sig, &signingKey, contiguousBuf.data(), contiguousBuf.size());
+    signMessage(sig, signingKey, contiguousBuf.data(), contiguousBuf.size());
   }
   auto sigSize = blsSignatureSerialize(encodingBuf, sizeof(encodingBuf), &sig);
   return Buffer(encodingBuf, sigSize);
@@ -150,10 +308,7 @@ ndnBLSVerify(const BLSPublicKey& pubKey, const Data& data)
 bool
 ndnBLSVerify(const std::vector<BLSPublicKey>& pubKeys, const Data& data)
 {
-  BLSPublicKey aggKey = pubKeys[0];
-  for (size_t i = 1; i < pubKeys.size(); i++) {
-    blsPublicKeyAdd(&aggKey, &pubKeys[i]);
-  }
+  BLSPublicKey aggKey = ndnBLSAggregatePublicKey(pubKeys);
   return ndnBLSVerify(aggKey, data);
 }
 
@@ -183,26 +338,345 @@ ndnBLSVerify(const std::vector<BLSPublicKey>& pubKeys, const Interest& interest)
   return ndnBLSVerify(aggKey, interest);
 }
 
+static bool
+batchVerifyRange(const BLSPublicKey* pubKeys, const BLSSignature* signatures, const Buffer* messages, size_t size)
+{
+  if (size == 0) {
+    return true;
+  }
+  // check e(-g1, sum(r_i * sig_i)) * prod(e(r_i * pk_i, H(m_i))) == 1
+  std::vector<BLSPublicKey> g1Points(size + 1);
+  std::vector<BLSSignature> g2Points(size + 1);
+  std::vector<BLSSignature> weightedSigs(signatures, signatures + size);
+  std::vector<BLSSecretKey> randoms(size);
+  uint8_t randomBytes[8];
+  for (size_t i = 0; i < size; i++) {
+    random::generateSecureBytes(randomBytes, sizeof(randomBytes));
+    randomBytes[0] |= 1; // non-zero scalar
+    blsSecretKeySetLittleEndian(&randoms[i], randomBytes, sizeof(randomBytes));
+    g1Points[i] = pubKeys[i];
+    blsPublicKeyMul(&g1Points[i], &randoms[i]);
+    if (blsHashToSignature(&g2Points[i], messages[i].data(), messages[i].size()) != 0) {
+      return false;
+    }
+  }
+  mclBnG2_mulVec(&g2Points[size].v, &weightedSigs.data()->v, &randoms.data()->v, size);
+  blsGetGeneratorOfPublicKey(&g1Points[size]);
+  mclBnG1_neg(&g1Points[size].v, &g1Points[size].v);
+
+  mclBnGT e;
+  mclBn_millerLoopVec(&e, &g1Points.data()->v, &g2Points.data()->v, size + 1);
+  mclBn_finalExp(&e, &e);
+  return mclBnGT_isOne(&e) == 1;
+}
+
+// the same-message case of batchVerifyRange, with the message hashed by the caller:
+// check e(-g1, sum(r_i * sig_i)) * e(sum(r_i * pk_i), H(m)) == 1
+static bool
+sameMessageVerifyRange(const BLSPublicKey* pubKeys, const BLSSignature* signatures, const BLSSignature& hashedMessage,
+                       size_t size)
+{
+  if (size == 0) {
+    return true;
+  }
+  std::vector<BLSSecretKey> randoms(size);
+  uint8_t randomBytes[8];
+  for (size_t i = 0; i < size; i++) {
+    random::generateSecureBytes(randomBytes, sizeof(randomBytes));
+    randomBytes[0] |= 1; // non-zero scalar
+    blsSecretKeySetLittleEndian(&randoms[i], randomBytes, sizeof(randomBytes));
+  }
+  std::vector<BLSPublicKey> weightedKeys(pubKeys, pubKeys + size);
+  std::vector<BLSSignature> weightedSigs(signatures, signatures + size);
+  BLSPublicKey g1Points[2];
+  BLSSignature g2Points[2];
+  mclBnG1_mulVec(&g1Points[0].v, &weightedKeys.data()->v, &randoms.data()->v, size);
+  g2Points[0] = hashedMessage;
+  blsGetGeneratorOfPublicKey(&g1Points[1]);
+  mclBnG1_neg(&g1Points[1].v, &g1Points[1].v);
+  mclBnG2_mulVec(&g2Points[1].v, &weightedSigs.data()->v, &randoms.data()->v, size);
+
+  mclBnGT e;
+  mclBn_millerLoopVec(&e, &g1Points[0].v, &g2Points[0].v, 2);
+  mclBn_finalExp(&e, &e);
+  return mclBnGT_isOne(&e) == 1;
+}
+
+/**
+ * Bisect [offset, offset + size) with @p verifyRange(offset, size) until the invalid signatures are found.
+ */
+template<typename VerifyRange>
+static void
+bisectInvalidSignatures(const VerifyRange& verifyRange, size_t offset, size_t size, bool knownInvalid,
+                        std::vector<size_t>& result)
+{
+  if (!knownInvalid && verifyRange(offset, size)) {
+    return;
+  }
+  if (size == 1) {
+    result.push_back(offset);
+    return;
+  }
+  auto half = size / 2;
+  auto resultSize = result.size();
+  bisectInvalidSignatures(verifyRange, offset, half, false, result);
+  // if the first half is valid, the second half must contain an invalid signature
+  bisectInvalidSignatures(verifyRange, offset + half, size - half, result.size() == resultSize, result);
+}
+
+bool
+ndnBLSBatchVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                  const std::vector<Buffer>& messages)
+{
+  if (pubKeys.size() != signatures.size() || pubKeys.size() != messages.size()) {
+    NDN_THROW(std::runtime_error("The numbers of keys, signatures, and messages do not match"));
+  }
+  return batchVerifyRange(pubKeys.data(), signatures.data(), messages.data(), pubKeys.size());
+}
+
+std::vector<size_t>
+ndnBLSFindInvalidSignatures(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                            const std::vector<Buffer>& messages)
+{
+  if (pubKeys.size() != signatures.size() || pubKeys.size() != messages.size()) {
+    NDN_THROW(std::runtime_error("The numbers of keys, signatures, and messages do not match"));
+  }
+  std::vector<size_t> result;
+  if (!pubKeys.empty()) {
+    bisectInvalidSignatures([&] (size_t offset, size_t size) {
+                              return batchVerifyRange(pubKeys.data() + offset, signatures.data() + offset,
+                                                      messages.data() + offset, size);
+                            },
+                            0, pubKeys.size(), false, result);
+  }
+  return result;
+}
+
+bool
+ndnBLSBatchVerifySameMessage(const std::vector<BLSPublicKey>& pubKeys, const std::vector<BLSSignature>& signatures,
+                             const Buffer& message)
+{
+  if (pubKeys.size() != signatures.size()) {
+    NDN_THROW(std::runtime_error("The numbers of keys and signatures do not match"));
+  }
+  BLSSignature hashedMessage;
+  if (blsHashToSignature(&hashedMessage, message.data(), message.size()) != 0) {
+    return false;
+  }
+  return sameMessageVerifyRange(pubKeys.data(), signatures.data(), hashedMessage, pubKeys.size());
+}
+
+std::vector<size_t>
+ndnBLSFindInvalidSignaturesSameMessage(const std::vector<BLSPublicKey>& pubKeys,
+                                       const std::vector<BLSSignature>& signatures, const Buffer& message)
+{
+  if (pubKeys.size() != signatures.size()) {
+    NDN_THROW(std::runtime_error("The numbers of keys and signatures do not match"));
+  }
+  std::vector<size_t> result;
+  if (pubKeys.empty()) {
+    return result;
+  }
+  // the message is hashed once for all the checks of the bisection
+  BLSSignature hashedMessage;
+  if (blsHashToSignature(&hashedMessage, message.data(), message.size()) != 0) {
+    NDN_THROW(std::runtime_error("Fail to hash the message"));
+  }
+  bisectInvalidSignatures([&] (size_t offset, size_t size) {
+                            return sameMessageVerifyRange(pubKeys.data() + offset, signatures.data() + offset,
+                                                          hashedMessage, size);
+                          },
+                          0, pubKeys.size(), false, result);
+  return result;
+}
+
+bool
+ndnBLSAggregateVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Buffer>& messages,
+                      const BLSSignature& aggregateSignature)
+{
+  if (pubKeys.size() != messages.size()) {
+    NDN_THROW(std::runtime_error("The numbers of keys and messages do not match"));
+  }
+  if (pubKeys.empty()) {
+    return false;
+  }
+  // uniqueness check
+  std::vector<const Buffer*> sortedMessages;
+  for (const auto& message : messages) {
+    sortedMessages.push_back(&message);
+  }
+  std::sort(sortedMessages.begin(), sortedMessages.end(),
+            [] (const Buffer* lhs, const Buffer* rhs) { return *lhs < *rhs; });
+  if (std::adjacent_find(sortedMessages.begin(), sortedMessages.end(),
+                         [] (const Buffer* lhs, const Buffer* rhs) { return *lhs == *rhs; }) != sortedMessages.end()) {
+    return false;
+  }
+
+  // check e(-g1, sig) * prod(e(pk_i, H(m_i))) == 1
+  auto size = pubKeys.size();
+  std::vector<BLSPublicKey> g1Points(pubKeys.begin(), pubKeys.end());
+  std::vector<BLSSignature> g2Points(size + 1);
+  for (size_t i = 0; i < size; i++) {
+    if (blsHashToSignature(&g2Points[i], messages[i].data(), messages[i].size()) != 0) {
+      return false;
+    }
+  }
+  g1Points.emplace_back();
+  blsGetGeneratorOfPublicKey(&g1Points[size]);
+  mclBnG1_neg(&g1Points[size].v, &g1Points[size].v);
+  g2Points[size] = aggregateSignature;
+
+  mclBnGT e;
+  mclBn_millerLoopVec(&e, &g1Points.data()->v, &g2Points.data()->v, size + 1);
+  mclBn_finalExp(&e, &e);
+  return mclBnGT_isOne(&e) == 1;
+}
+
+bool
+ndnBLSAggregateVerify(const std::vector<BLSPublicKey>& pubKeys, const std::vector<Data>& packets,
+                      const BLSSignature& aggregateSignature)
+{
+  std::vector<Buffer> messages;
+  messages.reserve(packets.size());
+  for (const auto& packet : packets) {
+    Buffer message;
+    for (const auto& bufPiece : packet.extractSignedRanges()) {
+      message.insert(message.end(), bufPiece.first, bufPiece.first + bufPiece.second);
+    }
+    messages.push_back(std::move(message));
+  }
+  return ndnBLSAggregateVerify(pubKeys, messages, aggregateSignature);
+}
+
+std::tuple<BLSPublicKey, std::vector<BLSSecretKey>>
+ndnBLSDealKeyShares(size_t threshold, size_t shareCount)
+{
+  if (threshold == 0 || threshold > shareCount) {
+    NDN_THROW(std::runtime_error("The threshold must be between 1 and the number of shares"));
+  }
+  // coefficients of the polynomial, the first one being the group secret key
+  std::vector<BLSSecretKey> coefficients(threshold);
+  for (auto& coefficient : coefficients) {
+    blsSecretKeySetByCSPRNG(&coefficient);
+  }
+  BLSPublicKey groupKey;
+  blsGetPublicKey(&groupKey, &coefficients[0]);
+  std::vector<BLSSecretKey> shares(shareCount);
+  for (size_t i = 0; i < shareCount; i++) {
+    blsId id;
+    blsIdSetInt(&id, static_cast<int>(i + 1));
+    if (blsSecretKeyShare(&shares[i], coefficients.data(), threshold, &id) != 0) {
+      NDN_THROW(std::runtime_error("Fail to generate the key share " + std::to_string(i + 1)));
+    }
+  }
+  for (auto& coefficient : coefficients) {
+    mclBnFr_clear(&coefficient.v);
+  }
+  return std::make_tuple(groupKey, std::move(shares));
+}
+
+BLSSignature
+ndnBLSRecoverSignature(const std::vector<BLSSignature>& pieces, const std::vector<uint64_t>& shareIds)
+{
+  if (pieces.size() != shareIds.size() || pieces.empty()) {
+    NDN_THROW(std::runtime_error("The numbers of signature pieces and share ids do not match"));
+  }
+  std::vector<blsId> ids(shareIds.size());
+  for (size_t i = 0; i < shareIds.size(); i++) {
+    if (shareIds[i] == 0 || shareIds[i] > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      NDN_THROW(std::runtime_error("Invalid share id " + std::to_string(shareIds[i])));
+    }
+    blsIdSetInt(&ids[i], static_cast<int>(shareIds[i]));
+  }
+  BLSSignature sig;
+  // fails if an id is repeated
+  if (blsSignatureRecover(&sig, pieces.data(), ids.data(), pieces.size()) != 0) {
+    NDN_THROW(std::runtime_error("Fail to recover the signature from the pieces"));
+  }
+  return sig;
+}
+
+// sets of at least this many points are split across threads
+static const size_t PARALLEL_AGGREGATION_THRESHOLD = 1024;
+
+static void
+addG1(BLSPublicKey* z, const BLSPublicKey* x, const BLSPublicKey* y)
+{
+  mclBnG1_add(&z->v, &x->v, &y->v);
+}
+
+static void
+addG2(BLSSignature* z, const BLSSignature* x, const BLSSignature* y)
+{
+  mclBnG2_add(&z->v, &x->v, &y->v);
+}
+
+template<typename Point, typename Add>
+static void
+accumulateRange(const Point* points, size_t size, Point& result, const Add& add)
+{
+  result = points[0];
+  for (size_t i = 1; i < size; i++) {
+    add(&result, &result, &points[i]);
+  }
+}
+
+/**
+ * Sum the points in Jacobian coordinates, without the normalization of each blsPublicKeyAdd
+ * or blsSignatureAdd. Large sets are summed in chunks by multiple threads, and the partial sums
+ * are added up in a binary tree. The result is normalized once.
+ */
+template<typename Point, typename Add, typename Normalize>
+static Point
+aggregatePoints(const Point* points, size_t size, const Add& add, const Normalize& normalize)
+{
+  if (size == 0) {
+    NDN_THROW(std::runtime_error("Cannot aggregate an empty set of points"));
+  }
+  size_t threadCount = 1;
+  if (size >= PARALLEL_AGGREGATION_THRESHOLD) {
+    threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(),
+                                                       size / (PARALLEL_AGGREGATION_THRESHOLD / 2)));
+  }
+  std::vector<Point> partialSums(threadCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < threadCount; i++) {
+    auto begin = size * i / threadCount;
+    auto end = size * (i + 1) / threadCount;
+    threads.emplace_back([=, &partialSums, &add] {
+      accumulateRange(points + begin, end - begin, partialSums[i], add);
+    });
+  }
+  accumulateRange(points, size / threadCount, partialSums[0], add);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t step = 1; step < threadCount; step <<= 1) {
+    for (size_t i = 0; i + step < threadCount; i += step << 1) {
+      add(&partialSums[i], &partialSums[i], &partialSums[i + step]);
+    }
+  }
+  normalize(partialSums[0]);
+  return partialSums[0];
+}
+
 BLSPublicKey
 ndnBLSAggregatePublicKey(const std::vector<BLSPublicKey>& pubKeys)
 {
-  BLSPublicKey aggKey = pubKeys[0];
-  for (size_t i = 1; i < pubKeys.size(); i++) {
-    blsPublicKeyAdd(&aggKey, &pubKeys[i]);
-  }
-  return aggKey;
+  return aggregatePoints(pubKeys.data(), pubKeys.size(), addG1,
+                         [] (BLSPublicKey& key) { mclBnG1_normalize(&key.v, &key.v); });
 }
 
 Buffer
 ndnBLSAggregateSignature(const std::vector<Buffer>& signatures)
 {
-  BLSSignature aggSig;
-  blsSignatureDeserialize(&aggSig, signatures[0].data(), signatures[0].size());
-  BLSSignature tempSig;
-  for (size_t i = 1; i < signatures.size(); i++) {
-    blsSignatureDeserialize(&tempSig, signatures[i].data(), signatures[i].size());
-    blsSignatureAdd(&aggSig, &tempSig);
+  std::vector<BLSSignature> sigs(signatures.size());
+  for (size_t i = 0; i < signatures.size(); i++) {
+    if (blsSignatureDeserialize(&sigs[i], signatures[i].data(), signatures[i].size()) == 0) {
+      NDN_THROW(std::runtime_error("Fail to deserialize the signature"));
+    }
   }
+  auto aggSig = ndnBLSAggregateSignature(sigs);
   auto sigSize = blsSignatureSerialize(encodingBuf, sizeof(encodingBuf), &aggSig);
   return Buffer(encodingBuf, sigSize);
 }
@@ -210,11 +684,8 @@ ndnBLSAggregateSignature(const std::vector<Buffer>& signatures)
 BLSSignature
 ndnBLSAggregateSignature(const std::vector<BLSSignature>& signatures)
 {
-  BLSSignature aggSig = signatures[0];
-  for (size_t i = 1; i < signatures.size(); i++) {
-    blsSignatureAdd(&aggSig, &signatures[i]);
-  }
-  return aggSig;
+  return aggregatePoints(signatures.data(), signatures.size(), addG2,
+                         [] (BLSSignature& sig) { mclBnG2_normalize(&sig.v, &sig.v); });
 }
 
 }  // namespace mps
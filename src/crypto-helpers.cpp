@@ -21,13 +21,17 @@
 #include "ndnmps/crypto-helpers.hpp"
 
 #include <boost/endian/conversion.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/encoding/buffer-stream.hpp>
 #include <ndn-cxx/security/transform/base64-decode.hpp>
 #include <ndn-cxx/security/transform/base64-encode.hpp>
 #include <ndn-cxx/security/transform/buffer-source.hpp>
 #include <ndn-cxx/security/transform/stream-sink.hpp>
 #include <ndn-cxx/util/random.hpp>
+#include <openssl/crypto.h>
 #include <openssl/ec.h>
 #include <openssl/err.h>
 #include <openssl/hmac.h>
@@ -37,26 +41,122 @@
 namespace ndn {
 namespace mps {
 
-ECDHState::ECDHState()
+/**
+ * @brief Get the prime256v1 parameters, which are generated once and shared by all key generations.
+ */
+static EVP_PKEY*
+getEcParams()
+{
+  static EVP_PKEY* params = [] {
+    EVP_PKEY* result = nullptr;
+    EVP_PKEY_CTX* ctx_params = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_paramgen_init(ctx_params);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx_params, NID_X9_62_prime256v1);
+    EVP_PKEY_paramgen(ctx_params, &result);
+    EVP_PKEY_CTX_free(ctx_params);
+    return result;
+  }();
+  if (params == nullptr) {
+    NDN_THROW(std::runtime_error("Error in generating ECDH parameters"));
+  }
+  return params;
+}
+
+static EVP_PKEY*
+generateEcKey()
 {
-  auto EC_NID = NID_X9_62_prime256v1;
-  // params context
-  EVP_PKEY_CTX* ctx_params = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
-  EVP_PKEY_paramgen_init(ctx_params);
-  EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx_params, EC_NID);
-  // generate params
-  EVP_PKEY* params = nullptr;
-  EVP_PKEY_paramgen(ctx_params, &params);
-  // key generation context
-  EVP_PKEY_CTX* ctx_keygen = EVP_PKEY_CTX_new(params, nullptr);
+  EVP_PKEY* key = nullptr;
+  EVP_PKEY_CTX* ctx_keygen = EVP_PKEY_CTX_new(getEcParams(), nullptr);
   EVP_PKEY_keygen_init(ctx_keygen);
-  auto resultCode = EVP_PKEY_keygen(ctx_keygen, &m_privkey);
+  auto resultCode = EVP_PKEY_keygen(ctx_keygen, &key);
   EVP_PKEY_CTX_free(ctx_keygen);
-  EVP_PKEY_free(params);
-  EVP_PKEY_CTX_free(ctx_params);
   if (resultCode <= 0) {
     NDN_THROW(std::runtime_error("Error in initiating ECDH"));
   }
+  return key;
+}
+
+ECDHKeyPool::ECDHKeyPool(size_t capacity, size_t lowWaterMark)
+  : m_capacity(capacity)
+  , m_lowWaterMark(std::min(lowWaterMark, capacity))
+{
+  getEcParams();
+  m_refillThread = std::thread([this] { refill(); });
+}
+
+ECDHKeyPool::~ECDHKeyPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopped = true;
+  }
+  m_refillCv.notify_one();
+  m_refillThread.join();
+  for (auto key : m_keys) {
+    EVP_PKEY_free(key);
+  }
+}
+
+EVP_PKEY*
+ECDHKeyPool::take()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_keys.empty()) {
+      auto key = m_keys.front();
+      m_keys.pop_front();
+      if (m_keys.size() <= m_lowWaterMark) {
+        m_refillCv.notify_one();
+      }
+      return key;
+    }
+  }
+  m_refillCv.notify_one();
+  return generateEcKey();
+}
+
+size_t
+ECDHKeyPool::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_keys.size();
+}
+
+void
+ECDHKeyPool::refill()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_isStopped) {
+    if (m_keys.size() >= m_capacity) {
+      m_refillCv.wait(lock, [this] { return m_isStopped || m_keys.size() <= m_lowWaterMark; });
+      continue;
+    }
+    // generate the key without holding the lock so that take() is not blocked
+    lock.unlock();
+    EVP_PKEY* key = nullptr;
+    try {
+      key = generateEcKey();
+    }
+    catch (const std::exception&) {
+    }
+    lock.lock();
+    if (key == nullptr) {
+      // take() generates the keys itself in the meantime
+      m_refillCv.wait_for(lock, std::chrono::seconds(1), [this] { return m_isStopped; });
+      continue;
+    }
+    m_keys.push_back(key);
+  }
+}
+
+ECDHState::ECDHState()
+  : ECDHState(nullptr)
+{
+}
+
+ECDHState::ECDHState(ECDHKeyPool* pool)
+  : m_privkey(pool != nullptr ? pool->take() : generateEcKey())
+{
 }
 
 ECDHState::~ECDHState()
@@ -123,83 +223,283 @@ ECDHState::deriveSecret(const std::vector<uint8_t>& peerKey)
   return m_secret;
 }
 
-void
-hmacSha256(const uint8_t* data, size_t dataLen,
-           const uint8_t* key, size_t keyLen,
-           uint8_t* result)
+namespace {
+
+struct CipherCtxDeleter
 {
-  auto ret = HMAC(EVP_sha256(), key, keyLen,
-                  data, dataLen, result, nullptr);
-  if (ret == nullptr) {
-    NDN_THROW(std::runtime_error("Error computing HMAC when calling HMAC()"));
+  void
+  operator()(EVP_CIPHER_CTX* ctx) const
+  {
+    EVP_CIPHER_CTX_free(ctx);
   }
+};
+
+struct HmacCtxDeleter
+{
+  void
+  operator()(HMAC_CTX* ctx) const
+  {
+    HMAC_CTX_free(ctx);
+  }
+};
+
+// OpenSSL reuses the previous HMAC key when the key pointer is null, so empty keys point here
+const uint8_t EMPTY_KEY[1] = {0};
+
+/**
+ * @brief The cipher context for one-off AES-GCM calls, allocated once per thread.
+ */
+EVP_CIPHER_CTX*
+getThreadCipherCtx()
+{
+  static thread_local std::unique_ptr<EVP_CIPHER_CTX, CipherCtxDeleter> ctx(EVP_CIPHER_CTX_new());
+  if (ctx == nullptr) {
+    NDN_THROW(std::runtime_error("Error in allocating the cipher context"));
+  }
+  return ctx.get();
 }
 
-size_t
-hkdf(const uint8_t* secret, size_t secretLen, const uint8_t* salt,
-     size_t saltLen, uint8_t* output, size_t outputLen,
-     const uint8_t* info, size_t infoLen)
+/**
+ * @brief The HMAC context for hmacSha256 and hkdf, allocated once per thread.
+ */
+HMAC_CTX*
+getThreadHmacCtx()
 {
-  EVP_PKEY_CTX* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr);
-  EVP_PKEY_derive_init(pctx);
-  EVP_PKEY_CTX_set_hkdf_md(pctx, EVP_sha256());
-  EVP_PKEY_CTX_set1_hkdf_salt(pctx, salt, saltLen);
-  EVP_PKEY_CTX_set1_hkdf_key(pctx, secret, secretLen);
-  EVP_PKEY_CTX_add1_hkdf_info(pctx, info, infoLen);
-  size_t outLen = outputLen;
-  auto resultCode = EVP_PKEY_derive(pctx, output, &outLen);
-  EVP_PKEY_CTX_free(pctx);
-  if (resultCode == 0) {
-    NDN_THROW(std::runtime_error("Error when calling HKDF"));
+  static thread_local std::unique_ptr<HMAC_CTX, HmacCtxDeleter> ctx(HMAC_CTX_new());
+  if (ctx == nullptr) {
+    NDN_THROW(std::runtime_error("Error in allocating the HMAC context"));
   }
-  return outLen;
+  return ctx.get();
 }
 
+// the context must have been keyed; only the IV is set here
 size_t
-aesGcm128Encrypt(const uint8_t* plaintext, size_t plaintextLen, const uint8_t* associated, size_t associatedLen,
-                 const uint8_t* key, const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag)
+gcmEncrypt(EVP_CIPHER_CTX* ctx, const uint8_t* plaintext, size_t plaintextLen,
+           const uint8_t* associated, size_t associatedLen,
+           const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag)
 {
   int len = 0;
   size_t ciphertextLen = 0;
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-  EVP_EncryptInit_ex(ctx, EVP_aes_128_gcm(), nullptr, nullptr, nullptr);
-  EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 12, nullptr);
-  EVP_EncryptInit_ex(ctx, nullptr, nullptr, key, iv);
-  EVP_EncryptUpdate(ctx, nullptr, &len, associated, associatedLen);
-  EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, plaintextLen);
+  auto resultCode = EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv);
+  if (associatedLen > 0) {
+    resultCode &= EVP_EncryptUpdate(ctx, nullptr, &len, associated, associatedLen);
+  }
+  resultCode &= EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, plaintextLen);
   ciphertextLen = len;
-  EVP_EncryptFinal_ex(ctx, ciphertext + len, &len);
-  auto resultCode = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, 16, tag);
-  EVP_CIPHER_CTX_free(ctx);
+  resultCode &= EVP_EncryptFinal_ex(ctx, ciphertext + len, &len);
+  ciphertextLen += len;
+  resultCode &= EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, 16, tag);
   if (resultCode == 0) {
     NDN_THROW(std::runtime_error("Error in encryption plaintext with AES GCM"));
   }
   return ciphertextLen;
 }
 
+// the context must have been keyed; only the IV is set here
 size_t
-aesGcm128Decrypt(const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* associated, size_t associatedLen,
-                 const uint8_t* tag, const uint8_t* key, const uint8_t* iv, uint8_t* plaintext)
+gcmDecrypt(EVP_CIPHER_CTX* ctx, const uint8_t* ciphertext, size_t ciphertextLen,
+           const uint8_t* associated, size_t associatedLen,
+           const uint8_t* tag, const uint8_t* iv, uint8_t* plaintext)
 {
   int len = 0;
   size_t plaintextLen = 0;
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-  EVP_DecryptInit_ex(ctx, EVP_aes_128_gcm(), nullptr, nullptr, nullptr);
-  EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 12, nullptr);
-  EVP_DecryptInit_ex(ctx, nullptr, nullptr, key, iv);
-  EVP_DecryptUpdate(ctx, nullptr, &len, associated, associatedLen);
+  EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, iv);
+  if (associatedLen > 0) {
+    EVP_DecryptUpdate(ctx, nullptr, &len, associated, associatedLen);
+  }
   EVP_DecryptUpdate(ctx, plaintext, &len, ciphertext, ciphertextLen);
   plaintextLen = len;
   EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, 16, const_cast<void*>(reinterpret_cast<const void*>(tag)));
   auto resultCode = EVP_DecryptFinal_ex(ctx, plaintext + len, &len);
   plaintextLen += len;
-  EVP_CIPHER_CTX_free(ctx);
-  if (resultCode == 0) {
+  if (resultCode <= 0) {
     NDN_THROW(std::runtime_error("Error in decrypting ciphertext with AES GCM"));
   }
   return plaintextLen;
 }
 
+void
+keyCipherCtx(EVP_CIPHER_CTX* ctx, bool isEncrypt, const uint8_t* key)
+{
+  auto init = isEncrypt ? EVP_EncryptInit_ex : EVP_DecryptInit_ex;
+  auto resultCode = init(ctx, EVP_aes_128_gcm(), nullptr, nullptr, nullptr);
+  resultCode &= EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN, 12, nullptr);
+  resultCode &= init(ctx, nullptr, nullptr, key, nullptr);
+  if (resultCode == 0) {
+    NDN_THROW(std::runtime_error("Error in initiating AES GCM"));
+  }
+}
+
+} // namespace
+
+void
+hmacSha256(const uint8_t* data, size_t dataLen,
+           const uint8_t* key, size_t keyLen,
+           uint8_t* result)
+{
+  auto ctx = getThreadHmacCtx();
+  unsigned int resultLen = 0;
+  if (HMAC_Init_ex(ctx, keyLen > 0 ? key : EMPTY_KEY, keyLen, EVP_sha256(), nullptr) == 0 ||
+      HMAC_Update(ctx, data, dataLen) == 0 ||
+      HMAC_Final(ctx, result, &resultLen) == 0) {
+    NDN_THROW(std::runtime_error("Error computing HMAC when calling HMAC()"));
+  }
+}
+
+size_t
+hkdf(const uint8_t* secret, size_t secretLen, const uint8_t* salt,
+     size_t saltLen, uint8_t* output, size_t outputLen,
+     const uint8_t* info, size_t infoLen)
+{
+  // RFC 5869, with SHA-256 as the hash function
+  const size_t hashLen = 32;
+  if (outputLen > 255 * hashLen) {
+    NDN_THROW(std::runtime_error("Error when calling HKDF"));
+  }
+  // extract: PRK = HMAC(salt, IKM), where an absent salt is HashLen zeros
+  uint8_t zeroSalt[hashLen] = {0};
+  uint8_t prk[hashLen];
+  if (saltLen == 0) {
+    hmacSha256(secret, secretLen, zeroSalt, hashLen, prk);
+  }
+  else {
+    hmacSha256(secret, secretLen, salt, saltLen, prk);
+  }
+  // expand: T(i) = HMAC(PRK, T(i-1) | info | i)
+  auto ctx = getThreadHmacCtx();
+  uint8_t block[hashLen];
+  unsigned int blockLen = 0;
+  size_t offset = 0;
+  for (uint8_t counter = 1; offset < outputLen; counter++) {
+    auto resultCode = HMAC_Init_ex(ctx, prk, hashLen, EVP_sha256(), nullptr);
+    if (counter > 1) {
+      resultCode &= HMAC_Update(ctx, block, hashLen);
+    }
+    if (infoLen > 0) {
+      resultCode &= HMAC_Update(ctx, info, infoLen);
+    }
+    resultCode &= HMAC_Update(ctx, &counter, 1);
+    resultCode &= HMAC_Final(ctx, block, &blockLen);
+    if (resultCode == 0) {
+      NDN_THROW(std::runtime_error("Error when calling HKDF"));
+    }
+    auto copyLen = std::min(hashLen, outputLen - offset);
+    std::memcpy(output + offset, block, copyLen);
+    offset += copyLen;
+  }
+  OPENSSL_cleanse(prk, sizeof(prk));
+  OPENSSL_cleanse(block, sizeof(block));
+  return outputLen;
+}
+
+void
+deriveResumedKeys(const uint8_t* secret, size_t secretLen, uint64_t ticketId, uint64_t counter,
+                  uint8_t* output, size_t outputLen)
+{
+  uint8_t salt[16];
+  boost::endian::native_to_big_inplace(counter);
+  boost::endian::native_to_big_inplace(ticketId);
+  std::memcpy(salt, &counter, 8);
+  std::memcpy(salt + 8, &ticketId, 8);
+  static const std::string info("ndnmps resumption");
+  hkdf(secret, secretLen, salt, sizeof(salt), output, outputLen,
+       reinterpret_cast<const uint8_t*>(info.data()), info.size());
+}
+
+void
+signDataWithHmacSha256(Data& data, const uint8_t* key, size_t keyLen)
+{
+  data.setSignatureInfo(SignatureInfo(ndn::tlv::SignatureHmacWithSha256));
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  uint8_t mac[32];
+  hmacSha256(encoder.buf(), encoder.size(), key, keyLen, mac);
+  data.wireEncode(encoder, makeBinaryBlock(ndn::tlv::SignatureValue, mac, sizeof(mac)));
+}
+
+bool
+verifyDataWithHmacSha256(const Data& data, const uint8_t* key, size_t keyLen)
+{
+  if (data.getSignatureType() != ndn::tlv::SignatureHmacWithSha256 ||
+      data.getSignatureValue().value_size() != 32) {
+    return false;
+  }
+  // the signed portion is not copied into a contiguous buffer
+  auto ctx = getThreadHmacCtx();
+  auto resultCode = HMAC_Init_ex(ctx, keyLen > 0 ? key : EMPTY_KEY, keyLen, EVP_sha256(), nullptr);
+  for (const auto& range : data.extractSignedRanges()) {
+    resultCode &= HMAC_Update(ctx, range.first, range.second);
+  }
+  uint8_t mac[32];
+  unsigned int macLen = 0;
+  resultCode &= HMAC_Final(ctx, mac, &macLen);
+  return resultCode != 0 && macLen == sizeof(mac) &&
+         CRYPTO_memcmp(mac, data.getSignatureValue().value(), sizeof(mac)) == 0;
+}
+
+size_t
+aesGcm128Encrypt(const uint8_t* plaintext, size_t plaintextLen, const uint8_t* associated, size_t associatedLen,
+                 const uint8_t* key, const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag)
+{
+  auto ctx = getThreadCipherCtx();
+  keyCipherCtx(ctx, true, key);
+  return gcmEncrypt(ctx, plaintext, plaintextLen, associated, associatedLen, iv, ciphertext, tag);
+}
+
+size_t
+aesGcm128Decrypt(const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* associated, size_t associatedLen,
+                 const uint8_t* tag, const uint8_t* key, const uint8_t* iv, uint8_t* plaintext)
+{
+  auto ctx = getThreadCipherCtx();
+  keyCipherCtx(ctx, false, key);
+  return gcmDecrypt(ctx, ciphertext, ciphertextLen, associated, associatedLen, tag, iv, plaintext);
+}
+
+AesGcm128Session::AesGcm128Session()
+  : m_encryptCtx(EVP_CIPHER_CTX_new())
+  , m_decryptCtx(EVP_CIPHER_CTX_new())
+{
+  if (m_encryptCtx == nullptr || m_decryptCtx == nullptr) {
+    EVP_CIPHER_CTX_free(m_encryptCtx);
+    EVP_CIPHER_CTX_free(m_decryptCtx);
+    NDN_THROW(std::runtime_error("Error in allocating the cipher context"));
+  }
+}
+
+AesGcm128Session::~AesGcm128Session()
+{
+  EVP_CIPHER_CTX_free(m_encryptCtx);
+  EVP_CIPHER_CTX_free(m_decryptCtx);
+}
+
+void
+AesGcm128Session::setKey(const uint8_t* key)
+{
+  keyCipherCtx(m_encryptCtx, true, key);
+  keyCipherCtx(m_decryptCtx, false, key);
+  m_hasKey = true;
+}
+
+size_t
+AesGcm128Session::encrypt(const uint8_t* plaintext, size_t plaintextLen, const uint8_t* associated,
+                          size_t associatedLen, const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag)
+{
+  if (!m_hasKey) {
+    NDN_THROW(std::runtime_error("AES GCM session is used before the key is set"));
+  }
+  return gcmEncrypt(m_encryptCtx, plaintext, plaintextLen, associated, associatedLen, iv, ciphertext, tag);
+}
+
+size_t
+AesGcm128Session::decrypt(const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* associated,
+                          size_t associatedLen, const uint8_t* tag, const uint8_t* iv, uint8_t* plaintext)
+{
+  if (!m_hasKey) {
+    NDN_THROW(std::runtime_error("AES GCM session is used before the key is set"));
+  }
+  return gcmDecrypt(m_decryptCtx, ciphertext, ciphertextLen, associated, associatedLen, tag, iv, plaintext);
+}
+
 // Can be removed after boost version 1.72, replaced by boost::endian::load_big_u32
 static uint32_t
 loadBigU32(const std::vector<uint8_t>& iv, size_t pos)
@@ -208,10 +508,10 @@ loadBigU32(const std::vector<uint8_t>& iv, size_t pos)
   return result;
 }
 
-Block
-encodeBlockWithAesGcm128(uint32_t tlvType, const uint8_t* key,
-                         const uint8_t* payload, size_t payloadSize,
-                         const uint8_t* associatedData, size_t associatedDataSize)
+template<typename Encrypt>
+static Block
+encodeBlockWithAesGcm128Impl(uint32_t tlvType, const uint8_t* payload, size_t payloadSize,
+                             const Encrypt& encrypt)
 {
   // The spec of AES encrypted payload TLV used in NDNCERT:
   //   https://github.com/named-data/ndncert/wiki/NDNCERT-Protocol-0.3#242-aes-gcm-encryption
@@ -220,8 +520,7 @@ encodeBlockWithAesGcm128(uint32_t tlvType, const uint8_t* key,
   std::vector<uint8_t> encryptionIv;
   encryptionIv.resize(12, 0);
   random::generateSecureBytes(encryptionIv.data(), 8);
-  size_t encryptedPayloadLen = aesGcm128Encrypt(payload, payloadSize, associatedData, associatedDataSize,
-                                                key, encryptionIv.data(), encryptedPayload.data(), tag);
+  size_t encryptedPayloadLen = encrypt(payload, payloadSize, encryptionIv.data(), encryptedPayload.data(), tag);
   Block content(tlvType);
   content.push_back(makeBinaryBlock(tlv::InitializationVector, encryptionIv.data(), encryptionIv.size()));
   content.push_back(makeBinaryBlock(tlv::AuthenticationTag, tag, 16));
@@ -230,19 +529,23 @@ encodeBlockWithAesGcm128(uint32_t tlvType, const uint8_t* key,
   return content;
 }
 
-Buffer
-decodeBlockWithAesGcm128(const Block& block, const uint8_t* key,
-                         const uint8_t* associatedData, size_t associatedDataSize)
+template<typename Decrypt>
+static Buffer
+decodeBlockWithAesGcm128Impl(const Block& block, const Decrypt& decrypt)
 {
   // The spec of AES encrypted payload TLV used in NDNCERT:
   //   https://github.com/named-data/ndncert/wiki/NDNCERT-Protocol-0.3#242-aes-gcm-encryption
   block.parse();
   const auto& encryptedPayloadBlock = block.get(tlv::EncryptedPayload);
+  const auto& ivBlock = block.get(tlv::InitializationVector);
+  const auto& tagBlock = block.get(tlv::AuthenticationTag);
+  if (ivBlock.value_size() != 12 || tagBlock.value_size() != 16) {
+    NDN_THROW(std::runtime_error("Error when decrypting the AES Encrypted Block: "
+                                 "IV or tag is of an unexpected size"));
+  }
   Buffer result(encryptedPayloadBlock.value_size());
-  std::vector<uint8_t> currentIv(block.get(tlv::InitializationVector).value(), block.get(tlv::InitializationVector).value() + 12);
-  auto resultLen = aesGcm128Decrypt(encryptedPayloadBlock.value(), encryptedPayloadBlock.value_size(),
-                                    associatedData, associatedDataSize, block.get(tlv::AuthenticationTag).value(),
-                                    key, currentIv.data(), result.data());
+  auto resultLen = decrypt(encryptedPayloadBlock.value(), encryptedPayloadBlock.value_size(),
+                           tagBlock.value(), ivBlock.value(), result.data());
   if (resultLen != encryptedPayloadBlock.value_size()) {
     NDN_THROW(std::runtime_error("Error when decrypting the AES Encrypted Block: "
                                     "Decrypted payload is of an unexpected size"));
@@ -250,6 +553,121 @@ decodeBlockWithAesGcm128(const Block& block, const uint8_t* key,
   return result;
 }
 
+Block
+encodeBlockWithAesGcm128(uint32_t tlvType, const uint8_t* key,
+                         const uint8_t* payload, size_t payloadSize,
+                         const uint8_t* associatedData, size_t associatedDataSize)
+{
+  return encodeBlockWithAesGcm128Impl(tlvType, payload, payloadSize,
+    [=] (const uint8_t* plaintext, size_t plaintextLen, const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag) {
+      return aesGcm128Encrypt(plaintext, plaintextLen, associatedData, associatedDataSize, key, iv, ciphertext, tag);
+    });
+}
+
+Block
+encodeBlockWithAesGcm128(uint32_t tlvType, AesGcm128Session& session,
+                         const uint8_t* payload, size_t payloadSize,
+                         const uint8_t* associatedData, size_t associatedDataSize)
+{
+  return encodeBlockWithAesGcm128Impl(tlvType, payload, payloadSize,
+    [&] (const uint8_t* plaintext, size_t plaintextLen, const uint8_t* iv, uint8_t* ciphertext, uint8_t* tag) {
+      return session.encrypt(plaintext, plaintextLen, associatedData, associatedDataSize, iv, ciphertext, tag);
+    });
+}
+
+Buffer
+decodeBlockWithAesGcm128(const Block& block, const uint8_t* key,
+                         const uint8_t* associatedData, size_t associatedDataSize)
+{
+  return decodeBlockWithAesGcm128Impl(block,
+    [=] (const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* tag, const uint8_t* iv, uint8_t* plaintext) {
+      return aesGcm128Decrypt(ciphertext, ciphertextLen, associatedData, associatedDataSize, tag, key, iv, plaintext);
+    });
+}
+
+Buffer
+decodeBlockWithAesGcm128(const Block& block, AesGcm128Session& session,
+                         const uint8_t* associatedData, size_t associatedDataSize)
+{
+  return decodeBlockWithAesGcm128Impl(block,
+    [&] (const uint8_t* ciphertext, size_t ciphertextLen, const uint8_t* tag, const uint8_t* iv, uint8_t* plaintext) {
+      return session.decrypt(ciphertext, ciphertextLen, associatedData, associatedDataSize, tag, iv, plaintext);
+    });
+}
+
+size_t
+prependBlockWithAesGcm128(EncodingBuffer& encoder, uint32_t tlvType, AesGcm128Session& session,
+                          const uint8_t* payload, size_t payloadSize,
+                          const uint8_t* associatedData, size_t associatedDataSize)
+{
+  // EncryptedPayload: the plaintext is copied once and then encrypted in place
+  size_t totalLength = encoder.prependByteArray(payload, payloadSize);
+  uint8_t tag[16];
+  uint8_t encryptionIv[12] = {0};
+  random::generateSecureBytes(encryptionIv, 8);
+  session.encrypt(encoder.buf(), payloadSize, associatedData, associatedDataSize,
+                  encryptionIv, encoder.buf(), tag);
+  totalLength += encoder.prependVarNumber(payloadSize);
+  totalLength += encoder.prependVarNumber(tlv::EncryptedPayload);
+  totalLength += prependByteArrayBlock(encoder, tlv::AuthenticationTag, tag, sizeof(tag));
+  totalLength += prependByteArrayBlock(encoder, tlv::InitializationVector, encryptionIv, sizeof(encryptionIv));
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlvType);
+  return totalLength;
+}
+
+std::tuple<size_t, size_t>
+decryptBlockWithAesGcm128InPlace(uint8_t* wire, size_t wireSize, AesGcm128Session& session,
+                                 const uint8_t* associatedData, size_t associatedDataSize)
+{
+  const uint8_t* pos = wire;
+  const uint8_t* end = wire + wireSize;
+  const uint8_t* iv = nullptr;
+  const uint8_t* tag = nullptr;
+  const uint8_t* encryptedPayload = nullptr;
+  size_t encryptedPayloadSize = 0;
+  try {
+    ndn::tlv::readType(pos, end);
+    auto length = ndn::tlv::readVarNumber(pos, end);
+    if (length != static_cast<uint64_t>(end - pos)) {
+      NDN_THROW(std::runtime_error("TLV-LENGTH does not match the block size"));
+    }
+    while (pos != end) {
+      auto type = ndn::tlv::readType(pos, end);
+      auto elementLength = ndn::tlv::readVarNumber(pos, end);
+      if (elementLength > static_cast<uint64_t>(end - pos)) {
+        NDN_THROW(std::runtime_error("TLV-LENGTH exceeds the block size"));
+      }
+      if (type == tlv::InitializationVector && elementLength == 12) {
+        iv = pos;
+      }
+      else if (type == tlv::AuthenticationTag && elementLength == 16) {
+        tag = pos;
+      }
+      else if (type == tlv::EncryptedPayload) {
+        encryptedPayload = pos;
+        encryptedPayloadSize = elementLength;
+      }
+      pos += elementLength;
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_THROW(std::runtime_error(std::string("Error when parsing the AES Encrypted Block: ") + e.what()));
+  }
+  if (iv == nullptr || tag == nullptr || encryptedPayload == nullptr) {
+    NDN_THROW(std::runtime_error("Error when parsing the AES Encrypted Block: missing IV, tag, or payload"));
+  }
+  // the IV and the tag are read before the payload is overwritten, and the payload is decrypted onto itself
+  auto plaintext = const_cast<uint8_t*>(encryptedPayload);
+  auto resultLen = session.decrypt(encryptedPayload, encryptedPayloadSize, associatedData, associatedDataSize,
+                                   tag, iv, plaintext);
+  if (resultLen != encryptedPayloadSize) {
+    NDN_THROW(std::runtime_error("Error when decrypting the AES Encrypted Block: "
+                                 "Decrypted payload is of an unexpected size"));
+  }
+  return std::make_tuple(static_cast<size_t>(plaintext - wire), resultLen);
+}
+
 std::string
 base64EncodeFromBytes(const uint8_t* data, size_t len, bool needBreak)
 {
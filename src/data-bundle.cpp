@@ -0,0 +1,86 @@
+#include "ndnmps/data-bundle.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace mps {
+
+BLSDataBundle::BLSDataBundle()
+{
+  mclBnG2_clear(&m_aggregateSignature.v);
+}
+
+BLSDataBundle::BLSDataBundle(const Block& wire)
+{
+  wireDecode(wire);
+}
+
+void
+BLSDataBundle::addPacket(Data data, const BLSSecretKey& signingKey, const Name& keyName)
+{
+  data.setSignatureInfo(SignatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                                      KeyLocator(keyName)));
+  BLSSignature sig;
+  {
+    EncodingBuffer encoder;
+    data.wireEncode(encoder, true);
+    blsSign(&sig, &signingKey, encoder.buf(), encoder.size());
+  }
+  blsSignatureAdd(&m_aggregateSignature, &sig);
+  // the signature only exists in the aggregate
+  data.setSignatureValue(std::make_shared<Buffer>());
+  data.wireEncode();
+  m_packets.push_back(std::move(data));
+}
+
+std::vector<Name>
+BLSDataBundle::getSignerKeyNames() const
+{
+  std::vector<Name> keyNames;
+  keyNames.reserve(m_packets.size());
+  for (const auto& packet : m_packets) {
+    keyNames.push_back(packet.getSignatureInfo().getKeyLocator().getName());
+  }
+  return keyNames;
+}
+
+Block
+BLSDataBundle::wireEncode() const
+{
+  auto wire = Block(tlv::DataBundle);
+  for (const auto& packet : m_packets) {
+    wire.push_back(packet.wireEncode());
+  }
+  uint8_t sigBuf[128];
+  auto sigSize = blsSignatureSerialize(sigBuf, sizeof(sigBuf), &m_aggregateSignature);
+  wire.push_back(makeBinaryBlock(tlv::BLSSigValue, sigBuf, sigSize));
+  wire.encode();
+  return wire;
+}
+
+void
+BLSDataBundle::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::DataBundle) {
+    NDN_THROW(ndn::tlv::Error("DataBundle", wire.type()));
+  }
+  wire.parse();
+  const auto& elements = wire.elements();
+  if (elements.size() < 2 || elements.back().type() != tlv::BLSSigValue) {
+    NDN_THROW(ndn::tlv::Error("DataBundle must contain Data packets followed by BLSSigValue"));
+  }
+  m_packets.clear();
+  for (auto it = elements.begin(); it != elements.end() - 1; ++it) {
+    if (it->type() != ndn::tlv::Data) {
+      NDN_THROW(ndn::tlv::Error("Data", it->type()));
+    }
+    m_packets.emplace_back(*it);
+  }
+  const auto& sigBlock = elements.back();
+  if (blsSignatureDeserialize(&m_aggregateSignature, sigBlock.value(), sigBlock.value_size()) == 0) {
+    NDN_THROW(ndn::tlv::Error("Cannot decode the aggregate signature of DataBundle"));
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -1,19 +1,45 @@
 #include "ndnmps/initiator.hpp"
 #include "ndnmps/crypto-helpers.hpp"
+#include "ndnmps/metrics.hpp"
+#include "ndnmps/tracer.hpp"
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/security/verification-helpers.hpp>
 #include <ndn-cxx/util/logger.hpp>
 #include <ndn-cxx/util/random.hpp>
+#include <algorithm>
 #include <utility>
 #include <future>
 #include <array>
-#include <iostream>
 
 namespace ndn {
 namespace mps {
 
 NDN_LOG_INIT(ndnmps.mpsinitiator);
 
+namespace {
+
+struct InitiatorMetrics
+{
+  MetricCounter& m_sessionsStarted = Metrics::get().counter("initiator.sessions_started");
+  MetricCounter& m_sessionsSucceeded = Metrics::get().counter("initiator.sessions_succeeded");
+  MetricCounter& m_sessionsFailed = Metrics::get().counter("initiator.sessions_failed");
+  MetricCounter& m_sessionsTimedOut = Metrics::get().counter("initiator.sessions_timed_out");
+  MetricCounter& m_unavailableSigners = Metrics::get().counter("initiator.unavailable_signers");
+  MetricCounter& m_invalidPieces = Metrics::get().counter("initiator.invalid_pieces");
+  LatencyHistogram& m_handshake = Metrics::get().histogram("initiator.handshake");
+  LatencyHistogram& m_pairing = Metrics::get().histogram("initiator.pairing");
+  LatencyHistogram& m_aggregation = Metrics::get().histogram("initiator.aggregation");
+};
+
+InitiatorMetrics&
+metrics()
+{
+  static InitiatorMetrics metrics;
+  return metrics;
+}
+
+} // namespace
+
 MPSInitiator::MPSInitiator(const Name& prefix, KeyChain& keyChain, Face& face, Scheduler& scheduler)
   : m_prefix(prefix)
     , m_keyChain(keyChain)
@@ -22,32 +48,95 @@ MPSInitiator::MPSInitiator(const Name& prefix, KeyChain& keyChain, Face& face, S
     , m_interestSigner(m_keyChain)
 {}
 
+struct SignaturePiece
+{
+  BLSSignature m_signature;
+  bool m_isVerified = false; // verified pieces are not checked again in later batches
+};
+
 struct MultiSignGlobalState
 {
   MpsSignerList m_signers;
   MultipartySchema m_schema;
+  std::unique_ptr<SignerSelectionSession> m_selection;
+  std::vector<Name> m_pendingUnavailableSigners;
+  std::vector<std::string> m_pendingUnavailableReasons; // the reason of each pending unavailable signer
+  scheduler::EventId m_replacementEvent;
   Data m_toBeSigned;
   Data m_signInfo;
-  std::vector<Buffer> m_fetchedSignatures;
+  Block m_parameter; // the unsigned Data, or the PayloadKey when the payload is encrypted once
+  RegisteredPrefixHandle m_payloadPrefixHandle;
+  Buffer m_signedPortion; // the message signed by every signer
+  std::map<Name, SignaturePiece> m_fetchedSignatures; // signer key name, signature piece
+  BLSSignature m_aggregateSignature; // running sum of the pieces in m_fetchedSignatures
+  std::shared_ptr<ThresholdGroup> m_thresholdGroup; // set in the threshold mode
   SignatureFinishCallback m_successCb;
   SignatureFailureCallback m_failureCb;
   Name m_signingKeyName;
+  uint64_t m_traceId = 0; // nonzero when the session is traced
+  TraceSpan m_sessionSpan;
+  std::map<Name, std::shared_ptr<MultiSignPerSignerState>> m_rpcs; // signer key name, ongoing request
+  scheduler::EventId m_deadlineEvent;
+  bool m_isFinished = false; // no callback or retry after the session succeeded or failed
 };
 
 struct MultiSignPerSignerState
 {
   Name m_signerKeyName;
-  ECDHState m_ecdh;
+  std::unique_ptr<ECDHState> m_ecdh; // not used by resumed requests
+  bool m_isResumed = false;
+  uint64_t m_ticketId = 0;
+  uint64_t m_ticketCounter = 0;
+  std::array<uint8_t, 32> m_resumptionSecret;
+  Block m_ticket; // the ticket issued by the signer after a full handshake
   std::promise<Data> m_paraDataPromise;
   std::array<uint8_t, 16> m_aesKey;
-  security::SigningInfo m_hmacSigningInfo;
+  AesGcm128Session m_aes; // keyed with m_aesKey
+  std::array<uint8_t, 32> m_hmacKey;
   Data m_paraData;
   Name m_nextResultName;
+  time::steady_clock::TimePoint m_processingDeadline;
   RegisteredPrefixHandle m_paraPrefixHandle;
+  PendingInterestHandle m_pendingInterest; // the sign request or the current result fetch
   scheduler::EventId m_resultFetchHandle;
-  std::function<void()> m_resultFetchCallback;
+  std::function<void()> m_resultFetchCallback; // captures the state itself, reset by cancelRpc
+  std::chrono::steady_clock::time_point m_requestTime; // only set when metrics are enabled
+  TraceSpan m_rpcSpan; // from the sign request to the signature piece or the failure of the signer
+  TraceSpan m_handshakeSpan; // from the sign request to the ACK
 };
 
+/**
+ * @brief Add the piece of the signer to the running aggregate, replacing its previous piece if any.
+ */
+void
+addSignaturePiece(MultiSignGlobalState& globalState, const Name& signerKeyName, const BLSSignature& signature)
+{
+  auto it = globalState.m_fetchedSignatures.find(signerKeyName);
+  if (it != globalState.m_fetchedSignatures.end()) {
+    blsSignatureSub(&globalState.m_aggregateSignature, &it->second.m_signature);
+  }
+  else {
+    it = globalState.m_fetchedSignatures.emplace(signerKeyName, SignaturePiece()).first;
+  }
+  it->second.m_signature = signature;
+  it->second.m_isVerified = false;
+  blsSignatureAdd(&globalState.m_aggregateSignature, &signature);
+}
+
+/**
+ * @brief Remove the contribution of the signer from the running aggregate.
+ */
+void
+removeSignaturePiece(MultiSignGlobalState& globalState, const Name& signerKeyName)
+{
+  auto it = globalState.m_fetchedSignatures.find(signerKeyName);
+  if (it == globalState.m_fetchedSignatures.end()) {
+    return;
+  }
+  blsSignatureSub(&globalState.m_aggregateSignature, &it->second.m_signature);
+  globalState.m_fetchedSignatures.erase(it);
+}
+
 std::tuple<Data, Data>
 prepareUnfinishedDataAndInfoData(const Data& unsignedData, const Name& initiatorPrefix)
 {
@@ -66,20 +155,59 @@ prepareUnfinishedDataAndInfoData(const Data& unsignedData, const Name& initiator
 }
 
 Data
-prepareParameterData(const Data& unfinishedData, const Name& initiatorPrefix)
+prepareParameterData(const Block& parameter, const Name& initiatorPrefix)
 {
   auto paraRandomness = random::generateSecureWord64();
   Name paraDataName = initiatorPrefix;
   paraDataName.append("mps").append("param").appendNumber(paraRandomness);
   Data paraData;  // /initiator/mps/para/[random]
   paraData.setName(paraDataName);
-  paraData.setContent(unfinishedData.wireEncode());
+  paraData.setContent(parameter);
   paraData.setFreshnessPeriod(time::seconds(4));
   return paraData;
 }
 
+/**
+ * @brief Cancel everything a request has scheduled or registered, so its state can be released.
+ */
+void
+cancelRpc(MultiSignPerSignerState& perSignerState)
+{
+  perSignerState.m_pendingInterest.cancel();
+  perSignerState.m_paraPrefixHandle.cancel();
+  perSignerState.m_resultFetchHandle.cancel();
+  perSignerState.m_resultFetchCallback = nullptr;
+}
+
+/**
+ * @brief Cancel the requests and the events of the session, and mark it as finished.
+ */
+void
+finishSession(MultiSignGlobalState& globalState)
+{
+  globalState.m_isFinished = true;
+  for (auto& item : globalState.m_rpcs) {
+    cancelRpc(*item.second);
+  }
+  globalState.m_rpcs.clear();
+  globalState.m_payloadPrefixHandle.cancel();
+  globalState.m_replacementEvent.cancel();
+  globalState.m_deadlineEvent.cancel();
+}
+
+void
+failSession(MultiSignGlobalState& globalState, const std::string& reason)
+{
+  finishSession(globalState);
+  metrics().m_sessionsFailed.increment();
+  globalState.m_sessionSpan.end({{"result", "failure"}, {"reason", reason}});
+  auto failureCb = std::move(globalState.m_failureCb);
+  failureCb(reason);
+}
+
 Interest
-prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName, const std::vector<uint8_t>& selfPubKey)
+prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName,
+                           const MultiSignPerSignerState& perSignerState, uint64_t traceId)
 {
   Interest signRequestInt;
   auto signRequestName = signerPrefix;
@@ -87,7 +215,17 @@ prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName, c
   signRequestInt.setName(signRequestName);
   Block appParam(ndn::tlv::ApplicationParameters);
   appParam.push_back(makeNestedBlock(tlv::ParameterDataName, paraDataName));
-  appParam.push_back(makeBinaryBlock(tlv::EcdhPub, selfPubKey.data(), selfPubKey.size()));
+  if (perSignerState.m_isResumed) {
+    appParam.push_back(makeNonNegativeIntegerBlock(tlv::TicketId, perSignerState.m_ticketId));
+    appParam.push_back(makeNonNegativeIntegerBlock(tlv::TicketCounter, perSignerState.m_ticketCounter));
+  }
+  else {
+    const auto& selfPubKey = perSignerState.m_ecdh->getSelfPubKey();
+    appParam.push_back(makeBinaryBlock(tlv::EcdhPub, selfPubKey.data(), selfPubKey.size()));
+  }
+  if (traceId != 0) {
+    appParam.push_back(makeNonNegativeIntegerBlock(tlv::TraceId, traceId));
+  }
   appParam.encode();
   signRequestInt.setApplicationParameters(appParam);
   signRequestInt.setCanBePrefix(false);
@@ -95,45 +233,61 @@ prepareSignRequestInterest(const Name& signerPrefix, const Name& paraDataName, c
   return signRequestInt;
 }
 
+/**
+ * @brief Install the AES key and the HMAC key (48 octets in total) of a request.
+ */
+void
+installRequestKeys(MultiSignPerSignerState& perSignerState, const uint8_t* aesAndHmac)
+{
+  std::memcpy(perSignerState.m_aesKey.data(), aesAndHmac, 16);
+  perSignerState.m_aes.setKey(perSignerState.m_aesKey.data());
+  // HMAC
+  std::memcpy(perSignerState.m_hmacKey.data(), aesAndHmac + 16, 32);
+}
+
 void
 parseAckReply(const Data& data, std::string& ackCode, time::milliseconds& result_ms, Name& resultName,
               std::shared_ptr<MultiSignPerSignerState> perSignerState)
 {
-  std::vector<uint8_t> peerPub;
-  std::array<uint8_t, 32> salt;
   auto contentBlock = data.getContent();
   contentBlock.parse();
   ackCode = readString(contentBlock.get(tlv::Status));
-  if (ackCode == "102") {
+  if (ackCode != "102") {
+    NDN_THROW(std::runtime_error("Rejected by the signer with Error code" + ackCode));
+  }
+  if (!perSignerState->m_isResumed) {
+    // the keys of resumed requests are derived from the ticket before the request is sent
+    std::vector<uint8_t> peerPub;
+    std::array<uint8_t, 32> salt;
     const auto& ecdhBlock = contentBlock.get(tlv::EcdhPub);
     peerPub.resize(ecdhBlock.value_size());
     std::memcpy(peerPub.data(), ecdhBlock.value(), ecdhBlock.value_size());
 
     const auto& saltBlock = contentBlock.get(tlv::Salt);
+    if (saltBlock.value_size() != salt.size()) {
+      NDN_THROW(std::runtime_error("Salt is of an unexpected size"));
+    }
     std::memcpy(salt.data(), saltBlock.value(), saltBlock.value_size());
+    // ECDH and generate HMAC KEY, AES KEY, and the resumption secret
+    auto dhSecret = perSignerState->m_ecdh->deriveSecret(peerPub);
+    std::array<uint8_t, 80> aesAndHmac;
+    hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
+    installRequestKeys(*perSignerState, aesAndHmac.data());
+    std::memcpy(perSignerState->m_resumptionSecret.data(), aesAndHmac.data() + 48, 32);
   }
-  else {
-    NDN_THROW(std::runtime_error("Rejected by the signer with Error code" + ackCode));
-  }
-  // ECDH and generate HMAC KEY and AES KEY
-  auto dhSecret = perSignerState->m_ecdh.deriveSecret(peerPub);
-  std::array<uint8_t, 48> aesAndHmac;
-  hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
-  std::memcpy(perSignerState->m_aesKey.data(), aesAndHmac.data(), 16);
-  auto hmacKeyStr = base64EncodeFromBytes(aesAndHmac.data() + 16, 32, false);
-  // HMAC
-  perSignerState->m_hmacSigningInfo.setSigningHmacKey(hmacKeyStr);
-  perSignerState->m_hmacSigningInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
-  perSignerState->m_hmacSigningInfo.setSignedInterestFormat(security::SignedInterestFormat::V03);
   // Decrypt
   Block decrypteBlock(ndn::tlv::Content,
                       std::make_shared<Buffer>(decodeBlockWithAesGcm128(contentBlock,
-                                                                        perSignerState->m_aesKey.data(),
+                                                                        perSignerState->m_aes,
                                                                         nullptr, 0)));
   decrypteBlock.parse();
   result_ms = time::milliseconds(readNonNegativeInteger(decrypteBlock.get(tlv::ResultAfter)));
   resultName.wireDecode(decrypteBlock.get(tlv::ResultName).blockFromValue());
-  std::cout << "result name: " << resultName.toUri() << std::endl;
+  auto ticketIt = decrypteBlock.find(tlv::Ticket);
+  if (ticketIt != decrypteBlock.elements_end()) {
+    perSignerState->m_ticket = *ticketIt;
+  }
+  NDN_LOG_TRACE("Result name: " << resultName);
 }
 
 Block
@@ -141,7 +295,7 @@ parseResultData(const Data& data, std::shared_ptr<MultiSignPerSignerState> perSi
 {
   auto contentBlock = data.getContent();
   contentBlock.parse();
-  auto decryptedBuf = decodeBlockWithAesGcm128(contentBlock, perSignerState->m_aesKey.data(), nullptr, 0);
+  auto decryptedBuf = decodeBlockWithAesGcm128(contentBlock, perSignerState->m_aes, nullptr, 0);
   auto decryptedBlock = makeBinaryBlock(ndn::tlv::Content, decryptedBuf.data(), decryptedBuf.size());
   decryptedBlock.parse();
   return decryptedBlock;
@@ -152,8 +306,16 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
 {
   auto perSignerState = std::make_shared<MultiSignPerSignerState>();
   perSignerState->m_signerKeyName = signerKeyName;
+  auto& rpc = globalState->m_rpcs[signerKeyName];
+  if (rpc != nullptr) {
+    cancelRpc(*rpc);
+  }
+  rpc = perSignerState;
+  if (!m_useResumption || !resumeSession(*perSignerState)) {
+    perSignerState->m_ecdh = make_unique<ECDHState>(m_ecdhKeyPool.get());
+  }
   // prepare un-encrypted parameter data
-  perSignerState->m_paraData = prepareParameterData(globalState->m_toBeSigned, m_prefix);
+  perSignerState->m_paraData = prepareParameterData(globalState->m_parameter, m_prefix);
   // prepare a future for finalized parameter data
   std::shared_future<Data> paraDataFuture(perSignerState->m_paraDataPromise.get_future());
   // register prefix to answer future parameter data
@@ -162,7 +324,7 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
     [paraDataFuture, this](const auto&,
                            const auto& interest) mutable
     {
-      std::cout << "\n\nInitiator: Receive Interest for parameter Data from signer." << std::endl;
+      NDN_LOG_TRACE("Received Interest for parameter Data: " << interest.getName());
       paraDataFuture.wait();
       m_face.put(paraDataFuture.get());
     },
@@ -171,21 +333,31 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
     {
       NDN_LOG_ERROR("Fail to register prefix " << prefix.toUri() << " because " << reason);
     });
-  // TODO: schedule an event for failure callback
 
   // send sign request Interest: /signer/mps/sign/hash
   auto signRequestInt = prepareSignRequestInterest(signerKeyName.getPrefix(-2),
                                                    perSignerState->m_paraData.getName(),
-                                                   perSignerState->m_ecdh.getSelfPubKey());
+                                                   *perSignerState, globalState->m_traceId);
+  signRequestInt.setInterestLifetime(m_requestTimeout);
   m_interestSigner.makeSignedInterest(signRequestInt, signingByKey(globalState->m_signingKeyName));
-  std::cout << "\n\nInitiator: Send MPS Sign Interest to signer: " << signerKeyName.getPrefix(-2).toUri() << std::endl;
-  m_face.expressInterest(
+  NDN_LOG_TRACE("Send sign request Interest to signer: " << signerKeyName.getPrefix(-2));
+  if (Metrics::isEnabled()) {
+    perSignerState->m_requestTime = std::chrono::steady_clock::now();
+  }
+  auto signerTrack = globalState->m_traceId != 0 ? "rpc " + signerKeyName.getPrefix(-2).toUri() : std::string();
+  perSignerState->m_rpcSpan = TraceSpan("rpc", globalState->m_traceId, signerTrack);
+  perSignerState->m_handshakeSpan = TraceSpan("handshake", globalState->m_traceId, signerTrack);
+  perSignerState->m_pendingInterest = m_face.expressInterest(
     signRequestInt,
     [=](const auto&, const auto& ackData)
     {
-      std::cout << "\n\nInitiator: Fetched ACK Data from signer: "
-                << ackData.getName().getPrefix(-3).toUri()
-                << std::endl << ackData;
+      metrics().m_handshake.recordSince(perSignerState->m_requestTime);
+      perSignerState->m_handshakeSpan.end({{"resumed", perSignerState->m_isResumed ? "true" : "false"}});
+      NDN_LOG_TRACE("Fetched ACK Data: " << ackData.getName());
+      if (readTraceId(ackData.getContent()) != globalState->m_traceId) {
+        NDN_LOG_INFO("ACK from signer " << perSignerState->m_signerKeyName.getPrefix(-2)
+                     << " does not echo the trace ID of the session");
+      }
 
       // parse ack content
       std::string ackCode;
@@ -195,75 +367,82 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
       }
       catch (const std::exception& e) {
         // should abort and change to another signer
-        std::cout << e.what() << std::endl;
+        NDN_LOG_INFO("Cannot parse the ACK from signer " << perSignerState->m_signerKeyName.getPrefix(-2)
+                     << ": " << e.what());
+        if (perSignerState->m_isResumed) {
+          // the signer no longer accepts the ticket: fall back to a full handshake
+          m_resumptions.erase(perSignerState->m_signerKeyName);
+          performRPC(perSignerState->m_signerKeyName, globalState);
+        }
+        else {
+          perSignerState->m_rpcSpan.end({{"status", "rejected"}});
+          onUnavailableSigner("Signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri() +
+                              " rejected the request: " + e.what(),
+                              perSignerState->m_signerKeyName, globalState);
+        }
         return;
       }
+      perSignerState->m_processingDeadline = time::steady_clock::now() + m_processingTimeout;
+      if (m_useResumption && perSignerState->m_ticket.isValid()) {
+        saveTicket(*perSignerState);
+      }
       // update paraData to be ready to be fetched
       const auto& unencryptedBlock = perSignerState->m_paraData.getContent();
-      auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content,
-                                                     perSignerState->m_aesKey.data(),
-                                                     unencryptedBlock.value(),
-                                                     unencryptedBlock.value_size(),
-                                                     nullptr, 0);
-      perSignerState->m_paraData.setContent(encryptedBlock);
-      m_keyChain.sign(perSignerState->m_paraData, perSignerState->m_hmacSigningInfo);
+      EncodingBuffer encoder(unencryptedBlock.value_size() + 64, 0);
+      prependBlockWithAesGcm128(encoder, ndn::tlv::Content, perSignerState->m_aes,
+                                unencryptedBlock.value(), unencryptedBlock.value_size(), nullptr, 0);
+      perSignerState->m_paraData.setContent(encoder.block());
+      signDataWithHmacSha256(perSignerState->m_paraData, perSignerState->m_hmacKey.data(),
+                             perSignerState->m_hmacKey.size());
       perSignerState->m_paraDataPromise.set_value(perSignerState->m_paraData);
-      std::cout << "Initiator: Register prefix for parameter data: "
-                << perSignerState->m_paraData.getName().toUri() << std::endl;
+      NDN_LOG_TRACE("Parameter Data is ready: " << perSignerState->m_paraData.getName());
 
       // set the scheduler to fetch the result
       perSignerState->m_resultFetchCallback = [=]()
       {
-        std::cout << "\n\nInitiator: Send Interest for result Data from signer: "
-                  << perSignerState->m_nextResultName.getPrefix(-3).toUri() << std::endl;
+        NDN_LOG_TRACE("Send Interest for result Data: " << perSignerState->m_nextResultName);
         perSignerState->m_paraPrefixHandle.cancel();
         Interest resultFetchInt(perSignerState->m_nextResultName);
         resultFetchInt.setCanBePrefix(true);
         resultFetchInt.setMustBeFresh(true);
+        resultFetchInt.setInterestLifetime(m_requestTimeout);
         m_interestSigner.makeSignedInterest(resultFetchInt, signingByKey(globalState->m_signingKeyName));
-        m_face.expressInterest(
+        perSignerState->m_pendingInterest = m_face.expressInterest(
           resultFetchInt,
           [=](const auto&, const auto& resultData)
           {
-            auto signerPrefix = resultData.getName().getPrefix(-5);
-
-            std::cout << "\n\nInitiator: Fetched result Data from signer: "
-                      << signerPrefix.toUri() << std::endl << resultData;
-            if (!security::verifySignature(resultData, m_keyChain.getTpm(),
-                                           perSignerState->m_hmacSigningInfo.getSignerName(),
-                                           DigestAlgorithm::SHA256)) {
-              std::cout << "Initiator: HMAC verification failed" << std::endl;
+            NDN_LOG_TRACE("Fetched result Data: " << resultData.getName());
+            if (!verifyDataWithHmacSha256(resultData, perSignerState->m_hmacKey.data(),
+                                          perSignerState->m_hmacKey.size())) {
+              NDN_LOG_INFO("HMAC verification of result Data failed");
               return;
             }
             auto resultContentBlock = parseResultData(resultData, perSignerState);
             auto code = readString(resultContentBlock.get(tlv::Status));
+            if (globalState->m_traceId != 0) {
+              Tracer::get().addInstantEvent("result", globalState->m_traceId, signerTrack, {{"status", code}});
+            }
             if (code == "200") {
               auto sigBlock = resultContentBlock.get(tlv::BLSSigValue);
-              globalState->m_fetchedSignatures.emplace_back(Buffer(sigBlock.value(), sigBlock.value_size()));
-              if (globalState->m_fetchedSignatures.size() ==
-                  globalState->m_signers.m_signers.size()) {
-                // all signatures have been fetched
-                auto begin = std::chrono::steady_clock::now();
-                auto aggSignature = std::make_shared<Buffer>(
-                  ndnBLSAggregateSignature(globalState->m_fetchedSignatures));
-                auto end = std::chrono::steady_clock::now();
-                std::cout << "Initiator aggregating signature pieces of size" << globalState->m_fetchedSignatures.size()
-                          << ": "
-                          << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                          << "[µs]" << std::endl;
-                globalState->m_toBeSigned.setSignatureValue(aggSignature);
-                globalState->m_toBeSigned.wireEncode();
-
-                // prepare the signature info packet
-                globalState->m_signInfo.setContent(globalState->m_signers.wireEncode());
-                m_keyChain.sign(globalState->m_signInfo, signingByKey(globalState->m_signingKeyName));
-                std::cout << "Initiator: info packet is ready" << std::endl;
-
-                // end the multiparty signature
-                globalState->m_successCb(globalState->m_toBeSigned, globalState->m_signInfo);
+              BLSSignature piece;
+              if (blsSignatureDeserialize(&piece, sigBlock.value(), sigBlock.value_size()) == 0) {
+                onUnavailableSigner("Malformed signature piece from signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
+                                    perSignerState->m_signerKeyName, globalState);
+                return;
               }
+              const auto& signers = globalState->m_signers.m_signers;
+              if (std::find(signers.begin(), signers.end(), perSignerState->m_signerKeyName) == signers.end()) {
+                // the signer has been replaced in the meantime
+                return;
+              }
+              perSignerState->m_rpcSpan.end({{"status", code}});
+              cancelRpc(*perSignerState);
+              globalState->m_rpcs.erase(perSignerState->m_signerKeyName);
+              addSignaturePiece(*globalState, perSignerState->m_signerKeyName, piece);
+              onSignaturePieceFetched(globalState);
             }
             else if (code != "102") {
+              perSignerState->m_rpcSpan.end({{"status", code}});
               onUnavailableSigner("Received Error code when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                                   perSignerState->m_signerKeyName, globalState);
             }
@@ -271,6 +450,13 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
               // processing
               auto result_ms = time::milliseconds(readNonNegativeInteger(resultContentBlock.get(tlv::ResultAfter)));
               Name newResultName(resultContentBlock.get(tlv::ResultName).blockFromValue());
+              if (time::steady_clock::now() + result_ms > perSignerState->m_processingDeadline) {
+                perSignerState->m_rpcSpan.end({{"status", "processing_timeout"}});
+                onUnavailableSigner("Signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri() +
+                                    " did not finish processing in time",
+                                    perSignerState->m_signerKeyName, globalState);
+                return;
+              }
               perSignerState->m_resultFetchHandle = m_scheduler.schedule(result_ms,
                                                                          perSignerState->m_resultFetchCallback);
             }
@@ -278,12 +464,14 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
           [=](const Interest& interest, const lp::Nack& nack)
           {
             NDN_LOG_ERROR("Received NACK with reason " << nack.getReason() << " for " << interest.getName());
+            perSignerState->m_rpcSpan.end({{"status", "nack"}});
             onUnavailableSigner("Received NACK when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                                 perSignerState->m_signerKeyName, globalState);
           },
           [=](const Interest& interest)
           {
             NDN_LOG_ERROR("interest time out for " << interest.getName());
+            perSignerState->m_rpcSpan.end({{"status", "timeout"}});
             onUnavailableSigner("Interest timeout when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                                 perSignerState->m_signerKeyName, globalState);
           }
@@ -294,12 +482,16 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
     [=](const Interest& interest, const lp::Nack& nack)
     {
       NDN_LOG_ERROR("Received NACK with reason " << nack.getReason() << " for " << interest.getName());
+      perSignerState->m_handshakeSpan.end({{"status", "nack"}});
+      perSignerState->m_rpcSpan.end({{"status", "nack"}});
       onUnavailableSigner("Received NACK when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                           perSignerState->m_signerKeyName, globalState);
     },
     [=](const Interest& interest)
     {
       NDN_LOG_ERROR("Interest time out for " << interest.getName());
+      perSignerState->m_handshakeSpan.end({{"status", "timeout"}});
+      perSignerState->m_rpcSpan.end({{"status", "timeout"}});
       onUnavailableSigner("Interest timeout when requesting signer " + perSignerState->m_signerKeyName.getPrefix(-2).toUri(),
                           perSignerState->m_signerKeyName, globalState);
     }
@@ -308,22 +500,81 @@ MPSInitiator::performRPC(const Name& signerKeyName, std::shared_ptr<MultiSignGlo
 
 void
 MPSInitiator::multiPartySign(const Data& unsignedData, const MultipartySchema& schema, const Name& signingKeyName,
-                             const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb)
+                             const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb,
+                             time::milliseconds timeout)
 {
   // init global state
+  metrics().m_sessionsStarted.increment();
   auto globalState = std::make_shared<MultiSignGlobalState>();
   globalState->m_schema = schema;
   globalState->m_successCb = successCb;
   globalState->m_failureCb = failureCb;
   globalState->m_signingKeyName = signingKeyName;
+  startSigning(unsignedData, timeout, globalState);
+}
+
+void
+MPSInitiator::thresholdSign(const Data& unsignedData, const ThresholdGroup& group, const Name& signingKeyName,
+                            const SignatureFinishCallback& successCb, const SignatureFailureCallback& failureCb,
+                            time::milliseconds timeout)
+{
+  metrics().m_sessionsStarted.increment();
+  auto globalState = std::make_shared<MultiSignGlobalState>();
+  // any t members of the group
+  globalState->m_schema.m_pktName = WildCardName(unsignedData.getName());
+  for (const auto& item : group.m_shareIds) {
+    globalState->m_schema.m_optionalSigners.emplace_back(item.first);
+  }
+  globalState->m_schema.m_minOptionalSigners = group.m_threshold;
+  globalState->m_successCb = successCb;
+  globalState->m_failureCb = failureCb;
+  globalState->m_signingKeyName = signingKeyName;
+  globalState->m_thresholdGroup = std::make_shared<ThresholdGroup>(group);
+  startSigning(unsignedData, timeout, globalState);
+}
+
+void
+MPSInitiator::startSigning(const Data& unsignedData, time::milliseconds timeout,
+                           std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  mclBnG2_clear(&globalState->m_aggregateSignature.v);
+  globalState->m_traceId = Tracer::newTraceId();
+  globalState->m_sessionSpan = TraceSpan(globalState->m_thresholdGroup != nullptr ? "threshold_session" : "session",
+                                         globalState->m_traceId, "initiator " + m_prefix.toUri());
   // get signer list
-  globalState->m_signers = m_schemaContainer.getAvailableSigners(schema);
-  if (globalState->m_signers.m_signers.size() == 0) {
-    failureCb("No sufficient number of known signers.");
+  try {
+    globalState->m_selection = std::make_unique<SignerSelectionSession>(m_schemaContainer, globalState->m_schema);
+  }
+  catch (const std::exception& e) {
+    // the session has started, so its end is reported through the failure callback
+    failSession(*globalState, e.what());
+    return;
   }
+  globalState->m_signers = globalState->m_selection->getSigners();
+  globalState->m_deadlineEvent = m_scheduler.schedule(timeout, [globalState] {
+    metrics().m_sessionsTimedOut.increment();
+    failSession(*globalState, "The session did not finish before its deadline.");
+  });
   // prepare the packet to be signed and the signature info packet
   std::tie(globalState->m_toBeSigned,
            globalState->m_signInfo) = prepareUnfinishedDataAndInfoData(unsignedData, m_prefix);
+  if (globalState->m_thresholdGroup != nullptr) {
+    // the signature will be verified with the group key directly
+    globalState->m_toBeSigned.setSignatureInfo(
+      SignatureInfo(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                    KeyLocator(globalState->m_thresholdGroup->m_groupKeyName)));
+  }
+  {
+    EncodingBuffer encoder;
+    globalState->m_toBeSigned.wireEncode(encoder, true);
+    globalState->m_signedPortion = Buffer(encoder.buf(), encoder.size());
+  }
+  if (m_encryptPayloadOnce) {
+    preparePayloadData(globalState);
+  }
+  else {
+    globalState->m_parameter = globalState->m_toBeSigned.wireEncode();
+  }
 
   for (const Name& signerKeyName : globalState->m_signers.m_signers) {
     // perform RPC with each signer
@@ -331,26 +582,252 @@ MPSInitiator::multiPartySign(const Data& unsignedData, const MultipartySchema& s
   }
 }
 
+void
+MPSInitiator::onSignaturePieceFetched(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  if (globalState->m_isFinished) {
+    return;
+  }
+  const auto& signers = globalState->m_signers.m_signers;
+  for (const auto& signer : signers) {
+    if (globalState->m_fetchedSignatures.count(signer) == 0) {
+      return;
+    }
+  }
+
+  // verify the new pieces with one batched check, and bisect only if it fails
+  std::vector<Name> unverifiedSigners;
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<BLSSignature> pieces;
+  for (const auto& signer : signers) {
+    const auto& fetched = globalState->m_fetchedSignatures[signer];
+    if (!fetched.m_isVerified) {
+      unverifiedSigners.push_back(signer);
+      pubKeys.push_back(m_schemaContainer.getTrustedKey(signer));
+      pieces.push_back(fetched.m_signature);
+    }
+  }
+  if (!unverifiedSigners.empty()) {
+    std::vector<size_t> invalidIndexes;
+    {
+      ScopedTimer timer(metrics().m_pairing);
+      invalidIndexes = ndnBLSFindInvalidSignaturesSameMessage(pubKeys, pieces, globalState->m_signedPortion);
+    }
+    NDN_LOG_DEBUG("Verified " << unverifiedSigners.size() << " signature pieces, "
+                  << invalidIndexes.size() << " invalid");
+    for (const auto& signer : unverifiedSigners) {
+      globalState->m_fetchedSignatures[signer].m_isVerified = true;
+    }
+    if (!invalidIndexes.empty()) {
+      metrics().m_invalidPieces.increment(invalidIndexes.size());
+      for (auto index : invalidIndexes) {
+        const auto& signer = unverifiedSigners[index];
+        removeSignaturePiece(*globalState, signer);
+        onUnavailableSigner("Invalid signature piece from signer " + signer.getPrefix(-2).toUri(),
+                            signer, globalState);
+      }
+      return;
+    }
+  }
+
+  if (globalState->m_thresholdGroup != nullptr) {
+    // interpolate the signature of the group key from the pieces of the key shares
+    ScopedTimer timer(metrics().m_aggregation);
+    std::vector<BLSSignature> shares;
+    std::vector<uint64_t> shareIds;
+    for (const auto& signer : signers) {
+      shares.push_back(globalState->m_fetchedSignatures[signer].m_signature);
+      shareIds.push_back(globalState->m_thresholdGroup->m_shareIds.at(signer));
+    }
+    auto groupSignature = ndnBLSRecoverSignature(shares, shareIds);
+    uint8_t sigBuf[128];
+    auto sigSize = blsSignatureSerialize(sigBuf, sizeof(sigBuf), &groupSignature);
+    globalState->m_toBeSigned.setSignatureValue(std::make_shared<Buffer>(sigBuf, sigSize));
+    globalState->m_toBeSigned.wireEncode();
+    timer.stop();
+    finishSession(*globalState);
+    metrics().m_sessionsSucceeded.increment();
+    globalState->m_sessionSpan.end({{"result", "success"}, {"signers", std::to_string(signers.size())}});
+    auto successCb = std::move(globalState->m_successCb);
+    successCb(globalState->m_toBeSigned, Data());
+    return;
+  }
+
+  // all signatures have been fetched and verified, and already added up on arrival
+  ScopedTimer timer(metrics().m_aggregation);
+  uint8_t sigBuf[128];
+  auto sigSize = blsSignatureSerialize(sigBuf, sizeof(sigBuf), &globalState->m_aggregateSignature);
+  globalState->m_toBeSigned.setSignatureValue(std::make_shared<Buffer>(sigBuf, sigSize));
+  globalState->m_toBeSigned.wireEncode();
+  timer.stop();
+
+  // prepare the signature info packet
+  if (m_useRosterSignerList && m_schemaContainer.m_roster != nullptr) {
+    globalState->m_signInfo.setContent(
+      m_schemaContainer.m_roster->encodeSignerList(globalState->m_signers));
+  }
+  else {
+    globalState->m_signInfo.setContent(globalState->m_signers.wireEncode());
+  }
+  m_keyChain.sign(globalState->m_signInfo, signingByKey(globalState->m_signingKeyName));
+  NDN_LOG_DEBUG("Signed " << globalState->m_toBeSigned.getName() << " with " << signers.size() << " signers");
+  finishSession(*globalState);
+  metrics().m_sessionsSucceeded.increment();
+  globalState->m_sessionSpan.end({{"result", "success"}, {"signers", std::to_string(signers.size())}});
+
+  // end the multiparty signature
+  auto successCb = std::move(globalState->m_successCb);
+  successCb(globalState->m_toBeSigned, globalState->m_signInfo);
+}
+
 void
 MPSInitiator::onUnavailableSigner(const std::string& reason,
                                   const Name& unavailbleSignerKeyName,
                                   std::shared_ptr<MultiSignGlobalState> globalState)
 {
+  if (globalState->m_isFinished) {
+    return;
+  }
+  NDN_LOG_DEBUG("Unavailable signer " << unavailbleSignerKeyName << ": " << reason);
+  metrics().m_unavailableSigners.increment();
+  auto rpc = globalState->m_rpcs.find(unavailbleSignerKeyName);
+  if (rpc != globalState->m_rpcs.end()) {
+    cancelRpc(*rpc->second);
+    globalState->m_rpcs.erase(rpc);
+  }
+  if (globalState->m_traceId != 0) {
+    Tracer::get().addInstantEvent("unavailable_signer", globalState->m_traceId,
+                                  "rpc " + unavailbleSignerKeyName.getPrefix(-2).toUri(), {{"reason", reason}});
+  }
+  // signers failing together (e.g., timeouts of one site) are replaced in one batch
+  globalState->m_pendingUnavailableSigners.push_back(unavailbleSignerKeyName);
+  globalState->m_pendingUnavailableReasons.push_back(reason);
+  if (!globalState->m_replacementEvent) {
+    globalState->m_replacementEvent = m_scheduler.schedule(time::milliseconds(0), [this, globalState] {
+      replaceUnavailableSigners(globalState);
+    });
+  }
+}
+
+void
+MPSInitiator::replaceUnavailableSigners(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  std::vector<Name> unavailableSigners;
+  unavailableSigners.swap(globalState->m_pendingUnavailableSigners);
+  std::vector<std::string> unavailableReasons;
+  unavailableReasons.swap(globalState->m_pendingUnavailableReasons);
+
   MpsSignerList newSigners;
   std::vector<Name> diffSigners;
-  std::tie(newSigners, diffSigners) = m_schemaContainer.replaceSigner(globalState->m_signers,
-                                                                      unavailbleSignerKeyName,
-                                                                      globalState->m_schema);
+  std::tie(newSigners, diffSigners) = globalState->m_selection->replaceSigners(unavailableSigners);
   if (newSigners.m_signers.empty()) {
-    globalState->m_failureCb(reason + " And we cannot find replacements for the unavailable signer");
+    // report every signer of the batch, not only the last one
+    std::string reason;
+    for (const auto& item : unavailableReasons) {
+      if (!reason.empty()) {
+        reason += "; ";
+      }
+      reason += item;
+    }
+    failSession(*globalState, reason + " And we cannot find replacements for the unavailable signers");
   }
   else {
     globalState->m_signers = newSigners;
+    // take the pieces of the replaced signers out of the aggregate
+    std::vector<Name> replacedSigners;
+    for (const auto& item : globalState->m_fetchedSignatures) {
+      if (std::find(newSigners.m_signers.begin(), newSigners.m_signers.end(), item.first) ==
+          newSigners.m_signers.end()) {
+        replacedSigners.push_back(item.first);
+      }
+    }
+    for (const auto& item : replacedSigners) {
+      removeSignaturePiece(*globalState, item);
+    }
     for (const auto& item : diffSigners) {
       performRPC(item, globalState);
     }
   }
 }
 
+bool
+MPSInitiator::resumeSession(MultiSignPerSignerState& perSignerState)
+{
+  auto it = m_resumptions.find(perSignerState.m_signerKeyName);
+  if (it == m_resumptions.end()) {
+    return false;
+  }
+  auto& resumption = it->second;
+  if (resumption.m_expiry <= time::steady_clock::now() || resumption.m_remainingRequests == 0) {
+    m_resumptions.erase(it);
+    return false;
+  }
+  resumption.m_counter++;
+  resumption.m_remainingRequests--;
+  perSignerState.m_isResumed = true;
+  perSignerState.m_ticketId = resumption.m_ticketId;
+  perSignerState.m_ticketCounter = resumption.m_counter;
+  std::array<uint8_t, 48> aesAndHmac;
+  deriveResumedKeys(resumption.m_secret.data(), resumption.m_secret.size(),
+                    resumption.m_ticketId, resumption.m_counter, aesAndHmac.data(), aesAndHmac.size());
+  installRequestKeys(perSignerState, aesAndHmac.data());
+  return true;
+}
+
+void
+MPSInitiator::saveTicket(const MultiSignPerSignerState& perSignerState)
+{
+  try {
+    const auto& ticket = perSignerState.m_ticket;
+    ticket.parse();
+    ResumptionState resumption;
+    resumption.m_secret = perSignerState.m_resumptionSecret;
+    resumption.m_ticketId = readNonNegativeInteger(ticket.get(tlv::TicketId));
+    resumption.m_counter = 0;
+    resumption.m_expiry = time::steady_clock::now() +
+                          time::milliseconds(readNonNegativeInteger(ticket.get(tlv::TicketLifetime)));
+    resumption.m_remainingRequests = readNonNegativeInteger(ticket.get(tlv::TicketBudget));
+    m_resumptions[perSignerState.m_signerKeyName] = resumption;
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_INFO("Ignored a malformed resumption ticket: " << e.what());
+  }
+}
+
+void
+MPSInitiator::preparePayloadData(std::shared_ptr<MultiSignGlobalState> globalState)
+{
+  // the payload is encrypted once, and every signer gets the same packet, which can be cached in the network
+  std::array<uint8_t, 16> contentKey;
+  random::generateSecureBytes(contentKey.data(), contentKey.size());
+  Name payloadName = m_prefix;
+  payloadName.append("mps").append("payload").appendNumber(random::generateSecureWord64());
+  Data payloadData(payloadName);  // /initiator/mps/payload/[random]
+  const auto& unfinishedWire = globalState->m_toBeSigned.wireEncode();
+  payloadData.setContent(encodeBlockWithAesGcm128(ndn::tlv::Content, contentKey.data(),
+                                                  unfinishedWire.wire(), unfinishedWire.size(), nullptr, 0));
+  payloadData.setFreshnessPeriod(time::seconds(4));
+  m_keyChain.sign(payloadData, signingByKey(globalState->m_signingKeyName));
+  globalState->m_payloadPrefixHandle = m_face.setInterestFilter(
+    payloadName,
+    [this, payloadData](const auto&, const auto&)
+    {
+      m_face.put(payloadData);
+    },
+    nullptr,
+    [](const Name& prefix, const std::string& reason)
+    {
+      NDN_LOG_ERROR("Fail to register prefix " << prefix.toUri() << " because " << reason);
+    });
+
+  // the content key is wrapped per signer when the parameter Data is encrypted
+  // the full name pins the payload Data by its implicit digest
+  Block payloadKey(tlv::PayloadKey);
+  payloadKey.push_back(makeBinaryBlock(tlv::ContentKey, contentKey.data(), contentKey.size()));
+  payloadKey.push_back(makeNestedBlock(tlv::PayloadName, payloadData.getFullName()));
+  payloadKey.encode();
+  globalState->m_parameter = payloadKey;
+}
+
 }  // namespace mps
 }  // namespace ndn
\ No newline at end of file
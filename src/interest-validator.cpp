@@ -0,0 +1,161 @@
+#include "ndnmps/interest-validator.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace ndn {
+namespace mps {
+
+NDN_LOG_INIT(ndnmps.interestvalidator);
+
+BLSInterestValidator::BLSInterestValidator(const MultipartySchemaContainer& schemaContainer)
+  : m_schemaContainer(schemaContainer)
+{
+}
+
+bool
+BLSInterestValidator::validate(const Interest& interest)
+{
+  return validate(std::vector<Interest>{interest}).front();
+}
+
+std::vector<bool>
+BLSInterestValidator::validate(const std::vector<Interest>& interests)
+{
+  std::vector<bool> results(interests.size(), false);
+  std::vector<size_t> candidates;
+  std::vector<Name> keyNames;
+  std::vector<SignatureInfo> infos;
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<BLSSignature> signatures;
+  std::vector<Buffer> messages;
+  for (size_t i = 0; i < interests.size(); i++) {
+    const auto& interest = interests[i];
+    auto info = interest.getSignatureInfo();
+    if (!info || info->getSignatureType() != tlv::SignatureSha256WithBls ||
+        !info->hasKeyLocator() || info->getKeyLocator().getType() != ndn::tlv::Name) {
+      NDN_LOG_DEBUG("Not a BLS-signed Interest: " << interest.getName());
+      continue;
+    }
+    const auto& keyName = info->getKeyLocator().getName();
+    if (!m_schemaContainer.isTrustedKey(keyName)) {
+      NDN_LOG_DEBUG("Untrusted key " << keyName << " of " << interest.getName());
+      continue;
+    }
+    // drop obvious replays before the pairings; the check is repeated in order once the signatures are verified
+    if (!checkReplay(keyName, *info)) {
+      NDN_LOG_DEBUG("Replayed Interest " << interest.getName());
+      continue;
+    }
+    BLSSignature signature;
+    const auto& sigValue = interest.getSignatureValue();
+    if (blsSignatureDeserialize(&signature, sigValue.value(), sigValue.value_size()) == 0) {
+      continue;
+    }
+    Buffer signedPortion;
+    for (const auto& bufPiece : interest.extractSignedRanges()) {
+      signedPortion.insert(signedPortion.end(), bufPiece.first, bufPiece.first + bufPiece.second);
+    }
+    candidates.push_back(i);
+    keyNames.push_back(keyName);
+    infos.push_back(*info);
+    pubKeys.push_back(m_schemaContainer.getTrustedKey(keyName));
+    signatures.push_back(signature);
+    messages.push_back(std::move(signedPortion));
+  }
+
+  auto invalidIndexes = ndnBLSFindInvalidSignatures(pubKeys, signatures, messages);
+  auto invalidIt = invalidIndexes.begin();
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (invalidIt != invalidIndexes.end() && *invalidIt == i) {
+      NDN_LOG_DEBUG("Invalid signature of " << interests[candidates[i]].getName());
+      invalidIt++;
+      continue;
+    }
+    // an earlier Interest of the burst may have used the same nonce or a later timestamp
+    if (!checkReplay(keyNames[i], infos[i])) {
+      continue;
+    }
+    updateRecord(keyNames[i], infos[i]);
+    results[candidates[i]] = true;
+  }
+  return results;
+}
+
+bool
+BLSInterestValidator::checkReplay(const Name& keyName, const SignatureInfo& info) const
+{
+  auto timestamp = info.getTime();
+  auto seqNum = info.getSeqNum();
+  auto nonce = info.getNonce();
+  if ((m_shouldValidateTimestamps && !timestamp) ||
+      (m_shouldValidateSeqNums && !seqNum) ||
+      (m_shouldValidateNonces && !nonce)) {
+    return false;
+  }
+  if (m_shouldValidateTimestamps) {
+    auto now = time::system_clock::now();
+    if (*timestamp < now - m_timestampGracePeriod || *timestamp > now + m_timestampGracePeriod) {
+      return false;
+    }
+  }
+
+  auto it = m_recordIndex.find(keyName);
+  if (it == m_recordIndex.end()) {
+    // the key may have had its record dropped
+    return !m_shouldValidateTimestamps || !m_evictionFloor || *timestamp > *m_evictionFloor;
+  }
+  const auto& record = it->second->second;
+  if (m_shouldValidateTimestamps && record.m_lastTimestamp && *timestamp <= *record.m_lastTimestamp) {
+    return false;
+  }
+  if (m_shouldValidateSeqNums && record.m_lastSeqNum && *seqNum <= *record.m_lastSeqNum) {
+    return false;
+  }
+  if (m_shouldValidateNonces && record.m_nonces.count(*nonce) > 0) {
+    return false;
+  }
+  return true;
+}
+
+void
+BLSInterestValidator::updateRecord(const Name& keyName, const SignatureInfo& info)
+{
+  auto it = m_recordIndex.find(keyName);
+  if (it == m_recordIndex.end()) {
+    m_records.emplace_front(keyName, ReplayRecord());
+    it = m_recordIndex.emplace(keyName, m_records.begin()).first;
+    if (m_records.size() > m_maxRecords) {
+      // every Interest accepted for the dropped key is at or below its last timestamp
+      const auto& lastTimestamp = m_records.back().second.m_lastTimestamp;
+      if (lastTimestamp && (!m_evictionFloor || *lastTimestamp > *m_evictionFloor)) {
+        m_evictionFloor = *lastTimestamp;
+      }
+      m_recordIndex.erase(m_records.back().first);
+      m_records.pop_back();
+    }
+  }
+  else {
+    m_records.splice(m_records.begin(), m_records, it->second);
+  }
+
+  auto& record = m_records.front().second;
+  if (m_shouldValidateTimestamps) {
+    record.m_lastTimestamp = info.getTime();
+  }
+  if (m_shouldValidateSeqNums) {
+    record.m_lastSeqNum = info.getSeqNum();
+  }
+  if (m_shouldValidateNonces) {
+    auto nonce = *info.getNonce();
+    if (record.m_nonces.insert(nonce).second) {
+      record.m_nonceOrder.push_back(std::move(nonce));
+    }
+    while (record.m_nonceOrder.size() > m_maxNoncesPerKey) {
+      record.m_nonces.erase(record.m_nonceOrder.front());
+      record.m_nonceOrder.pop_front();
+    }
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
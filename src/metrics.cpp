@@ -0,0 +1,218 @@
+#include "ndnmps/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ndn {
+namespace mps {
+
+std::atomic<bool> Metrics::s_isEnabled{false};
+
+constexpr size_t LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t LatencyHistogram::SUB_BUCKET_COUNT;
+constexpr size_t LatencyHistogram::BUCKET_COUNT;
+
+void
+MetricCounter::increment(uint64_t value)
+{
+  if (Metrics::isEnabled()) {
+    m_value.fetch_add(value, std::memory_order_relaxed);
+  }
+}
+
+size_t
+LatencyHistogram::getBucketIndex(uint64_t value)
+{
+  if (value < SUB_BUCKET_COUNT) {
+    return value;
+  }
+  size_t exponent = 63 - __builtin_clzll(value);
+  size_t shift = exponent - SUB_BUCKET_BITS;
+  size_t subBucket = (value >> shift) - SUB_BUCKET_COUNT;
+  return SUB_BUCKET_COUNT + shift * SUB_BUCKET_COUNT + subBucket;
+}
+
+uint64_t
+LatencyHistogram::getBucketUpperBound(size_t index)
+{
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+  size_t shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+  uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+  uint64_t lowerBound = (SUB_BUCKET_COUNT + subBucket) << shift;
+  return lowerBound + ((uint64_t(1) << shift) - 1);
+}
+
+void
+LatencyHistogram::record(uint64_t value)
+{
+  if (!Metrics::isEnabled()) {
+    return;
+  }
+  m_buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(value, std::memory_order_relaxed);
+  auto min = m_min.load(std::memory_order_relaxed);
+  while (value < min && !m_min.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+  }
+  auto max = m_max.load(std::memory_order_relaxed);
+  while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+void
+LatencyHistogram::recordSince(std::chrono::steady_clock::time_point begin)
+{
+  if (begin == std::chrono::steady_clock::time_point()) {
+    return;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - begin;
+  record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+LatencyHistogram::Snapshot
+LatencyHistogram::snapshot() const
+{
+  Snapshot snapshot;
+  // updates racing with the snapshot may be partially included
+  for (size_t i = 0; i < BUCKET_COUNT; i++) {
+    snapshot.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+  }
+  snapshot.m_count = m_count.load(std::memory_order_relaxed);
+  snapshot.m_sum = m_sum.load(std::memory_order_relaxed);
+  snapshot.m_min = snapshot.m_count == 0 ? 0 : m_min.load(std::memory_order_relaxed);
+  snapshot.m_max = m_max.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void
+LatencyHistogram::reset()
+{
+  for (auto& bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_count.store(0, std::memory_order_relaxed);
+  m_sum.store(0, std::memory_order_relaxed);
+  m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t
+LatencyHistogram::Snapshot::getPercentile(double percentile) const
+{
+  uint64_t total = 0;
+  for (auto bucket : m_buckets) {
+    total += bucket;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(percentile / 100 * total));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKET_COUNT; i++) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      return std::min(getBucketUpperBound(i), m_max);
+    }
+  }
+  return m_max;
+}
+
+Metrics&
+Metrics::get()
+{
+  static Metrics metrics;
+  return metrics;
+}
+
+MetricCounter&
+Metrics::counter(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& counter = m_counters[name];
+  if (counter == nullptr) {
+    counter = make_unique<MetricCounter>();
+  }
+  return *counter;
+}
+
+LatencyHistogram&
+Metrics::histogram(const std::string& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& histogram = m_histograms[name];
+  if (histogram == nullptr) {
+    histogram = make_unique<LatencyHistogram>();
+  }
+  return *histogram;
+}
+
+std::map<std::string, uint64_t>
+Metrics::snapshotCounters() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::map<std::string, uint64_t> result;
+  for (const auto& item : m_counters) {
+    result.emplace(item.first, item.second->get());
+  }
+  return result;
+}
+
+std::map<std::string, LatencyHistogram::Snapshot>
+Metrics::snapshotHistograms() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::map<std::string, LatencyHistogram::Snapshot> result;
+  for (const auto& item : m_histograms) {
+    result.emplace(item.first, item.second->snapshot());
+  }
+  return result;
+}
+
+std::string
+Metrics::toJson() const
+{
+  std::ostringstream os;
+  os << "{\"counters\": {";
+  bool isFirst = true;
+  for (const auto& item : snapshotCounters()) {
+    os << (isFirst ? "" : ", ") << "\"" << item.first << "\": " << item.second;
+    isFirst = false;
+  }
+  os << "}, \"histograms\": {";
+  isFirst = true;
+  for (const auto& item : snapshotHistograms()) {
+    const auto& snapshot = item.second;
+    os << (isFirst ? "" : ", ") << "\"" << item.first << "\": {"
+       << "\"count\": " << snapshot.m_count
+       << ", \"sum\": " << snapshot.m_sum
+       << ", \"min\": " << snapshot.m_min
+       << ", \"max\": " << snapshot.m_max
+       << ", \"p50\": " << snapshot.getPercentile(50)
+       << ", \"p90\": " << snapshot.getPercentile(90)
+       << ", \"p99\": " << snapshot.getPercentile(99)
+       << ", \"p999\": " << snapshot.getPercentile(99.9)
+       << "}";
+    isFirst = false;
+  }
+  os << "}}";
+  return os.str();
+}
+
+void
+Metrics::reset()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto& item : m_counters) {
+    item.second->reset();
+  }
+  for (auto& item : m_histograms) {
+    item.second->reset();
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
@@ -1,5 +1,6 @@
 #include "ndnmps/mps-signer-list.hpp"
 
+#include <algorithm>
 #include <utility>
 
 namespace ndn {
@@ -65,5 +66,157 @@ operator<<(std::ostream& os, const MpsSignerList& signerList)
   return os << "]";
 }
 
+static Buffer::const_iterator
+findElementEnd(Buffer::const_iterator pos, Buffer::const_iterator end)
+{
+  ndn::tlv::readType(pos, end);
+  auto length = ndn::tlv::readVarNumber(pos, end);
+  if (length > static_cast<uint64_t>(std::distance(pos, end))) {
+    NDN_THROW(ndn::tlv::Error("TLV-LENGTH of a signer name exceeds the signer list"));
+  }
+  return pos + length;
+}
+
+static uint64_t
+hashSignerName(Buffer::const_iterator begin, Buffer::const_iterator end)
+{
+  // FNV-1a, finalized with a 64-bit mixer so that the sum over a list stays well distributed
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (auto it = begin; it != end; ++it) {
+    hash = (hash ^ *it) * 0x100000001b3ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+MpsSignerListView::const_iterator::const_iterator(const MpsSignerListView* view, Buffer::const_iterator pos)
+  : m_view(view)
+  , m_pos(pos)
+{
+}
+
+Block
+MpsSignerListView::const_iterator::operator*() const
+{
+  auto end = findElementEnd(m_pos, m_view->m_wire.value_end());
+  return Block(m_view->m_wire.getBuffer(), m_pos, end, false);
+}
+
+MpsSignerListView::const_iterator&
+MpsSignerListView::const_iterator::operator++()
+{
+  m_pos = findElementEnd(m_pos, m_view->m_wire.value_end());
+  return *this;
+}
+
+MpsSignerListView::const_iterator
+MpsSignerListView::const_iterator::operator++(int)
+{
+  auto copy = *this;
+  ++(*this);
+  return copy;
+}
+
+MpsSignerListView::MpsSignerListView(const Block& wire)
+  : m_wire(wire)
+{
+  if (m_wire.type() != tlv::MpsSignerList) {
+    NDN_THROW(ndn::tlv::Error("MultiPartySignerList", m_wire.type()));
+  }
+  auto prevBegin = m_wire.value_end();
+  auto prevEnd = m_wire.value_end();
+  for (auto pos = m_wire.value_begin(); pos != m_wire.value_end();) {
+    auto typePos = pos;
+    if (ndn::tlv::readType(typePos, m_wire.value_end()) != ndn::tlv::Name) {
+      NDN_THROW(ndn::tlv::Error("MultiPartySignerList contains an element that is not a Name"));
+    }
+    auto end = findElementEnd(pos, m_wire.value_end());
+    m_hash += hashSignerName(pos, end);
+    if (prevBegin != m_wire.value_end() &&
+        std::lexicographical_compare(pos, end, prevBegin, prevEnd)) {
+      m_isSorted = false;
+    }
+    prevBegin = pos;
+    prevEnd = end;
+    pos = end;
+    m_size++;
+  }
+}
+
+MpsSignerList
+MpsSignerListView::toSignerList() const
+{
+  std::vector<Name> signers;
+  signers.reserve(m_size);
+  for (const auto& nameBlock : *this) {
+    signers.emplace_back(nameBlock);
+  }
+  return MpsSignerList(std::move(signers));
+}
+
+bool
+MpsSignerListView::operator==(const MpsSignerListView& rhs) const
+{
+  if (m_size != rhs.m_size || m_hash != rhs.m_hash) {
+    return false;
+  }
+  if (m_isSorted && rhs.m_isSorted) {
+    // both lists are in sorted wire order: compare the encodings in one pass
+    return std::equal(m_wire.value_begin(), m_wire.value_end(), rhs.m_wire.value_begin(), rhs.m_wire.value_end());
+  }
+  using Range = std::pair<Buffer::const_iterator, Buffer::const_iterator>;
+  auto sortedRanges = [] (const MpsSignerListView& view) {
+    std::vector<Range> ranges;
+    ranges.reserve(view.m_size);
+    for (auto pos = view.m_wire.value_begin(); pos != view.m_wire.value_end();) {
+      auto end = findElementEnd(pos, view.m_wire.value_end());
+      ranges.emplace_back(pos, end);
+      pos = end;
+    }
+    std::sort(ranges.begin(), ranges.end(), [] (const Range& a, const Range& b) {
+      return std::lexicographical_compare(a.first, a.second, b.first, b.second);
+    });
+    return ranges;
+  };
+  auto lhsRanges = sortedRanges(*this);
+  auto rhsRanges = sortedRanges(rhs);
+  return std::equal(lhsRanges.begin(), lhsRanges.end(), rhsRanges.begin(), [] (const Range& a, const Range& b) {
+    return std::equal(a.first, a.second, b.first, b.second);
+  });
+}
+
+int
+compareName(const Name& name, const Block& nameWire)
+{
+  // components are ordered by type, then by length, then by value
+  auto pos = nameWire.value_begin();
+  auto end = nameWire.value_end();
+  for (size_t i = 0; i < name.size(); i++) {
+    if (pos == end) {
+      return 1;
+    }
+    auto type = ndn::tlv::readType(pos, end);
+    auto length = ndn::tlv::readVarNumber(pos, end);
+    if (length > static_cast<uint64_t>(std::distance(pos, end))) {
+      NDN_THROW(ndn::tlv::Error("TLV-LENGTH of a name component exceeds the name"));
+    }
+    const auto& component = name.get(i);
+    if (component.type() != type) {
+      return component.type() < type ? -1 : 1;
+    }
+    if (component.value_size() != length) {
+      return component.value_size() < length ? -1 : 1;
+    }
+    auto mismatch = std::mismatch(component.value_begin(), component.value_end(), pos);
+    if (mismatch.first != component.value_end()) {
+      return *mismatch.first < *mismatch.second ? -1 : 1;
+    }
+    pos += length;
+  }
+  return pos == end ? 0 : -1;
+}
+
 }  // namespace mps
 }  // namespace ndn
\ No newline at end of file
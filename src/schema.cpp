@@ -3,6 +3,7 @@
 #include <boost/property_tree/info_parser.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <utility>
@@ -95,6 +96,31 @@ WildCardName::match(const Name& name) const
   return true;
 }
 
+bool
+WildCardName::match(const Block& nameWire) const
+{
+  auto pos = nameWire.value_begin();
+  auto end = nameWire.value_end();
+  size_t i = 0;
+  for (; pos != end; i++) {
+    if (i >= m_name.size()) {
+      return false;
+    }
+    ndn::tlv::readType(pos, end);
+    auto length = ndn::tlv::readVarNumber(pos, end);
+    if (length > static_cast<uint64_t>(std::distance(pos, end))) {
+      return false;
+    }
+    const auto& component = m_name.get(i);
+    if (component.type() != WILDCARD_NAME_TYPE &&
+        !std::equal(component.value_begin(), component.value_end(), pos, pos + length)) {
+      return false;
+    }
+    pos += length;
+  }
+  return i == m_name.size();
+}
+
 MultipartySchema
 fromSchemaSection(const SchemaSection& config)
 {
@@ -187,12 +213,13 @@ MultipartySchema::toString()
   return ss.str();
 }
 
-bool
-MultipartySchema::passSchema(const std::vector<Name>& signers) const
+template<typename SignerRange>
+static bool
+passSchemaImpl(const MultipartySchema& schema, const SignerRange& signers)
 {
   // make sure all required signers are listed
   size_t count = 0;
-  for (const auto& pattern : m_signers) {
+  for (const auto& pattern : schema.m_signers) {
     count = 0;
     for (const auto& item : signers) {
       if (pattern.match(item)) {
@@ -205,7 +232,7 @@ MultipartySchema::passSchema(const std::vector<Name>& signers) const
   }
   // check optional signers
   size_t totalMatchedKeys = 0;
-  for (const auto& pattern : m_optionalSigners) {
+  for (const auto& pattern : schema.m_optionalSigners) {
     count = 0;
     for (const auto& item : signers) {
       if (pattern.match(item)) {
@@ -214,17 +241,148 @@ MultipartySchema::passSchema(const std::vector<Name>& signers) const
     }
     totalMatchedKeys += std::min(count, pattern.m_times);
   }
-  if (totalMatchedKeys >= m_minOptionalSigners) {
+  if (totalMatchedKeys >= schema.m_minOptionalSigners) {
     return true;
   }
   return false;
 }
 
+bool
+MultipartySchema::passSchema(const std::vector<Name>& signers) const
+{
+  return passSchemaImpl(*this, signers);
+}
+
+bool
+MultipartySchema::passSchema(const MpsSignerListView& signers) const
+{
+  // the name elements are matched in place, without decoding them into Names
+  return passSchemaImpl(*this, signers);
+}
+
+void
+MultipartySchemaContainer::loadTrustedIds(const std::string& rosterFile, bool shouldVerifyPops)
+{
+  auto roster = std::make_shared<TrustedKeyRoster>(rosterFile);
+  if (shouldVerifyPops) {
+    auto invalidIndexes = roster->findInvalidProofsOfPossession();
+    if (!invalidIndexes.empty()) {
+      NDN_THROW(std::runtime_error("Invalid proof of possession of " +
+                                   roster->getKeyNames()[invalidIndexes.front()].toUri() + " in roster " + rosterFile));
+    }
+  }
+  m_roster = std::move(roster);
+}
+
+std::vector<Name>
+MultipartySchemaContainer::importCertificates(const std::vector<security::Certificate>& certs)
+{
+  std::vector<Name> rejected;
+  std::vector<const security::Certificate*> candidates;
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<BLSSignature> signatures;
+  std::vector<Buffer> messages;
+  for (const auto& cert : certs) {
+    // cheap checks first: self-signed BLS certificate that is currently valid
+    BLSPublicKey pubKey;
+    BLSSignature signature;
+    const auto& content = cert.getContent();
+    const auto& sigValue = cert.getSignatureValue();
+    const auto& sigInfo = cert.getSignatureInfo();
+    if (sigInfo.getSignatureType() != tlv::SignatureSha256WithBls ||
+        !sigInfo.hasKeyLocator() ||
+        sigInfo.getKeyLocator().getType() != ndn::tlv::Name ||
+        sigInfo.getKeyLocator().getName() != cert.getKeyName() ||
+        !cert.isValid() ||
+        blsPublicKeyDeserialize(&pubKey, content.value(), content.value_size()) == 0 ||
+        blsSignatureDeserialize(&signature, sigValue.value(), sigValue.value_size()) == 0) {
+      rejected.push_back(cert.getName());
+      continue;
+    }
+    Buffer signedPortion;
+    for (const auto& bufPiece : cert.extractSignedRanges()) {
+      signedPortion.insert(signedPortion.end(), bufPiece.first, bufPiece.first + bufPiece.second);
+    }
+    candidates.push_back(&cert);
+    pubKeys.push_back(pubKey);
+    signatures.push_back(signature);
+    messages.push_back(std::move(signedPortion));
+  }
+
+  auto invalidIndexes = ndnBLSFindInvalidSignatures(pubKeys, signatures, messages);
+  auto invalidIt = invalidIndexes.begin();
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (invalidIt != invalidIndexes.end() && *invalidIt == i) {
+      rejected.push_back(candidates[i]->getName());
+      invalidIt++;
+      continue;
+    }
+    m_trustedIds[candidates[i]->getKeyName()] = pubKeys[i];
+  }
+  return rejected;
+}
+
+bool
+MultipartySchemaContainer::isTrustedKey(const Name& keyName) const
+{
+  if (m_trustedIds.count(keyName) != 0) {
+    return true;
+  }
+  return m_roster != nullptr && m_roster->find(keyName) != TrustedKeyRoster::npos;
+}
+
+const BLSPublicKey&
+MultipartySchemaContainer::getTrustedKey(const Name& keyName) const
+{
+  auto it = m_trustedIds.find(keyName);
+  if (it != m_trustedIds.end()) {
+    return it->second;
+  }
+  if (m_roster != nullptr) {
+    auto index = m_roster->find(keyName);
+    if (index != TrustedKeyRoster::npos) {
+      return m_roster->getPublicKey(index);
+    }
+  }
+  NDN_THROW(std::runtime_error("Schema container does not have sufficient keys. Missing key for " + keyName.toUri()));
+}
+
+const BLSPublicKey*
+MultipartySchemaContainer::findTrustedKey(const Block& keyNameWire) const
+{
+  try {
+    auto it = m_trustedIds.find(keyNameWire);
+    if (it != m_trustedIds.end()) {
+      return &it->second;
+    }
+    if (m_roster != nullptr) {
+      auto index = m_roster->find(keyNameWire);
+      if (index != TrustedKeyRoster::npos) {
+        return &m_roster->getPublicKey(index);
+      }
+    }
+  }
+  catch (const ndn::tlv::Error&) {
+  }
+  return nullptr;
+}
+
+const BLSPublicKey&
+MultipartySchemaContainer::getTrustedKey(const Block& keyNameWire) const
+{
+  auto pubKey = findTrustedKey(keyNameWire);
+  if (pubKey == nullptr) {
+    NDN_THROW(std::runtime_error("Schema container does not have sufficient keys. Missing key for " +
+                                 Name(keyNameWire).toUri()));
+  }
+  return *pubKey;
+}
+
 bool
 MultipartySchemaContainer::passSchema(const Name& packetName, const MpsSignerList& signers) const
 {
   for (const auto& item : signers.m_signers) {
-    if (m_trustedIds.count(item) == 0) {
+    if (!isTrustedKey(item)) {
       return false;
     }
   }
@@ -236,6 +394,33 @@ MultipartySchemaContainer::passSchema(const Name& packetName, const MpsSignerLis
   return false;
 }
 
+bool
+MultipartySchemaContainer::passSchema(const Name& packetName, const MpsSignerListView& signers,
+                                      std::vector<const BLSPublicKey*>* pubKeys) const
+{
+  std::vector<const BLSPublicKey*> signerKeys;
+  signerKeys.reserve(signers.size());
+  for (const auto& nameBlock : signers) {
+    auto pubKey = findTrustedKey(nameBlock);
+    if (pubKey == nullptr) {
+      return false;
+    }
+    signerKeys.push_back(pubKey);
+  }
+  for (const auto& schema : m_schemas) {
+    if (schema.match(packetName)) {
+      if (!schema.passSchema(signers)) {
+        return false;
+      }
+      if (pubKeys != nullptr) {
+        *pubKeys = std::move(signerKeys);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
 MpsSignerList
 MultipartySchemaContainer::getAvailableSigners(const MultipartySchema& schema) const
 {
@@ -273,103 +458,205 @@ MultipartySchemaContainer::getAvailableSigners(const MultipartySchema& schema) c
 BLSPublicKey
 MultipartySchemaContainer::aggregateKey(const MpsSignerList& signers) const
 {
-  BLSPublicKey aggKey;
-  bool init = false;
+  std::vector<BLSPublicKey> pubKeys;
+  pubKeys.reserve(signers.m_signers.size());
   for (const auto& item : signers.m_signers) {
-    if (m_trustedIds.count(item) != 0) {
-      if (!init) {
-        aggKey = m_trustedIds.at(item);
-        init = true;
-      }
-      else {
-        blsPublicKeyAdd(&aggKey, &m_trustedIds.at(item));
-      }
-    }
-    else {
-      NDN_THROW(std::runtime_error("Schema container does not have sufficient keys. Missing key for " + item.toUri()));
-    }
+    pubKeys.push_back(getTrustedKey(item));
   }
-  return aggKey;
+  return ndnBLSAggregatePublicKey(pubKeys);
 }
 
-std::tuple<MpsSignerList, std::vector<Name>>
-MultipartySchemaContainer::replaceSigner(const MpsSignerList& signers,
-                                         const Name& unavailableKey,
-                                         const MultipartySchema& schema) const
+BLSPublicKey
+MultipartySchemaContainer::aggregateKey(const MpsSignerListView& signers) const
 {
-  m_unavailableSigners.insert(unavailableKey);
+  std::vector<BLSPublicKey> pubKeys;
+  pubKeys.reserve(signers.size());
+  for (const auto& nameBlock : signers) {
+    pubKeys.push_back(getTrustedKey(nameBlock));
+  }
+  return ndnBLSAggregatePublicKey(pubKeys);
+}
 
-  std::set<Name> newResultSet(signers.m_signers.begin(), signers.m_signers.end());
-  newResultSet.erase(unavailableKey);
-  std::set<Name> diffSet;
-  bool findReplacement = false;
-  Name replacementName;
+std::vector<Name>
+MultipartySchemaContainer::getMatchedKeys(const WildCardName& pattern) const
+{
+  std::set<Name> resultSet;
+  for (const auto& item : m_trustedIds) {
+    if (pattern.match(item.first)) {
+      resultSet.insert(item.first);
+    }
+  }
+  if (m_roster != nullptr) {
+    for (const auto& keyName : m_roster->getKeyNames()) {
+      if (pattern.match(keyName)) {
+        resultSet.insert(keyName);
+      }
+    }
+  }
+  return std::vector<Name>(resultSet.begin(), resultSet.end());
+}
 
-  // find the corresponding required signer schema that matches the unavailable name
+SignerSelectionSession::SignerSelectionSession(const MultipartySchemaContainer& container,
+                                               const MultipartySchema& schema)
+  : m_minOptionalSigners(schema.m_minOptionalSigners)
+{
   for (const auto& pattern : schema.m_signers) {
-    if (pattern.match(unavailableKey)) {
-      std::tie(findReplacement, replacementName) = findANewKeyForPattern(newResultSet, pattern);
-      if (findReplacement) {
-        if (!replacementName.empty()) {
-          newResultSet.insert(replacementName);
-          diffSet.insert(replacementName);
-        }
+    m_required.emplace_back();
+    m_required.back().m_pattern = pattern;
+  }
+  for (const auto& pattern : schema.m_optionalSigners) {
+    m_optional.emplace_back();
+    m_optional.back().m_pattern = pattern;
+  }
+  // one pass over the trusted IDs
+  auto matchKey = [this](const Name& keyName) {
+    for (auto& state : m_required) {
+      if (state.m_pattern.match(keyName)) {
+        state.m_candidates.push_back(keyName);
       }
-      else {
-        // Schema container does not have sufficient keys that are available
-        return std::make_tuple(MpsSignerList(), std::vector<Name>());
+    }
+    for (auto& state : m_optional) {
+      if (state.m_pattern.match(keyName)) {
+        state.m_candidates.push_back(keyName);
       }
     }
+  };
+  for (const auto& item : container.m_trustedIds) {
+    matchKey(item.first);
   }
-  // find the corresponding optional signer schema that matches the unavailable name
-  for (const auto& pattern : schema.m_optionalSigners) {
-    std::tie(findReplacement, replacementName) = findANewKeyForPattern(newResultSet, pattern);
-    if (findReplacement && replacementName.empty()) {
-      continue;
+  if (container.m_roster != nullptr) {
+    for (const auto& keyName : container.m_roster->getKeyNames()) {
+      matchKey(keyName);
     }
-    if (findReplacement && !replacementName.empty()) {
-      // find a new matched name that has not been included yet
-      newResultSet.insert(replacementName);
-      diffSet.insert(replacementName);
-      break;
+    // both sources are sorted, but a key may be in both of them
+    for (auto* states : {&m_required, &m_optional}) {
+      for (auto& state : *states) {
+        std::sort(state.m_candidates.begin(), state.m_candidates.end());
+        state.m_candidates.erase(std::unique(state.m_candidates.begin(), state.m_candidates.end()),
+                                 state.m_candidates.end());
+      }
     }
   }
-  return std::make_tuple(MpsSignerList(std::vector<Name>(newResultSet.begin(), newResultSet.end())),
-                         std::vector<Name>(diffSet.begin(), diffSet.end()));
+
+  std::vector<Name> added;
+  if (!fillRequiredSigners(added)) {
+    NDN_THROW(std::runtime_error("Schema container does not have sufficient keys. Missing required key(s)"));
+  }
+  if (!fillOptionalSigners(added)) {
+    NDN_THROW(std::runtime_error("Schema container does not have sufficient keys. Missing optional keys"));
+  }
 }
 
-std::vector<Name>
-MultipartySchemaContainer::getMatchedKeys(const WildCardName& pattern) const
+MpsSignerList
+SignerSelectionSession::getSigners() const
 {
-  std::set<Name> resultSet;
-  for (const auto& item : m_trustedIds) {
-    if (pattern.match(item.first) && m_unavailableSigners.count(item.first) == 0) {
-      resultSet.insert(item.first);
+  return MpsSignerList(std::vector<Name>(m_selected.begin(), m_selected.end()));
+}
+
+std::tuple<MpsSignerList, std::vector<Name>>
+SignerSelectionSession::replaceSigners(const std::vector<Name>& unavailableKeys)
+{
+  for (const auto& keyName : unavailableKeys) {
+    m_unavailable.insert(keyName);
+    if (m_selected.count(keyName) != 0) {
+      deselect(keyName);
     }
   }
-  return std::vector<Name>(resultSet.begin(), resultSet.end());
+  std::vector<Name> added;
+  if (!fillRequiredSigners(added) || !fillOptionalSigners(added)) {
+    // Schema container does not have sufficient keys that are available
+    return std::make_tuple(MpsSignerList(), std::vector<Name>());
+  }
+  std::sort(added.begin(), added.end());
+  return std::make_tuple(getSigners(), added);
 }
 
-std::tuple<bool, Name>
-MultipartySchemaContainer::findANewKeyForPattern(const std::set<Name>& existingSigners, WildCardName pattern) const
+void
+SignerSelectionSession::select(const Name& keyName)
 {
-  size_t count = 0;
-  for (const auto& item : existingSigners) {
-    if (pattern.match(item)) {
-      count++;
+  m_selected.insert(keyName);
+  for (auto& state : m_required) {
+    if (state.m_pattern.match(keyName)) {
+      state.m_selectedCount++;
     }
   }
-  if (count >= pattern.m_times) {
-    // no need to find replacement
-    return std::make_tuple(true, Name());
+  for (auto& state : m_optional) {
+    if (state.m_pattern.match(keyName)) {
+      state.m_selectedCount++;
+    }
   }
-  auto matchedKeys = getMatchedKeys(pattern);
-  for (const auto& matchedKey : matchedKeys) {
-    if (existingSigners.count(matchedKey) == 0) {
-      return std::make_tuple(true, matchedKey);
+}
+
+void
+SignerSelectionSession::deselect(const Name& keyName)
+{
+  m_selected.erase(keyName);
+  for (auto& state : m_required) {
+    if (state.m_pattern.match(keyName)) {
+      state.m_selectedCount--;
     }
   }
-  return std::make_tuple(false, Name());
+  for (auto& state : m_optional) {
+    if (state.m_pattern.match(keyName)) {
+      state.m_selectedCount--;
+    }
+  }
+}
+
+bool
+SignerSelectionSession::selectNextCandidate(PatternState& state, std::vector<Name>& added)
+{
+  // keys before the cursor are either selected or unavailable, so they never need to be tried again
+  while (state.m_next < state.m_candidates.size()) {
+    const auto& candidate = state.m_candidates[state.m_next++];
+    if (m_selected.count(candidate) == 0 && m_unavailable.count(candidate) == 0) {
+      select(candidate);
+      added.push_back(candidate);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+SignerSelectionSession::fillRequiredSigners(std::vector<Name>& added)
+{
+  for (auto& state : m_required) {
+    while (state.m_selectedCount < state.m_pattern.m_times) {
+      if (!selectNextCandidate(state, added)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+SignerSelectionSession::fillOptionalSigners(std::vector<Name>& added)
+{
+  size_t count = countOptionalSigners();
+  for (auto& state : m_optional) {
+    while (count < m_minOptionalSigners && state.m_selectedCount < state.m_pattern.m_times) {
+      if (!selectNextCandidate(state, added)) {
+        break;
+      }
+      count = countOptionalSigners();
+    }
+    if (count >= m_minOptionalSigners) {
+      return true;
+    }
+  }
+  return count >= m_minOptionalSigners;
+}
+
+size_t
+SignerSelectionSession::countOptionalSigners() const
+{
+  size_t count = 0;
+  for (const auto& state : m_optional) {
+    count += std::min(state.m_selectedCount, state.m_pattern.m_times);
+  }
+  return count;
 }
 
 }  // namespace mps
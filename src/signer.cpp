@@ -1,13 +1,16 @@
 #include "ndnmps/signer.hpp"
+#include "ndnmps/metrics.hpp"
+#include "ndnmps/tracer.hpp"
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/util/logger.hpp>
 #include <ndn-cxx/util/random.hpp>
 #include <ndn-cxx/security/transform/base64-decode.hpp>
 #include <ndn-cxx/security/transform/buffer-source.hpp>
 #include <ndn-cxx/security/verification-helpers.hpp>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 #include <future>
-#include <iostream>
 
 namespace ndn {
 namespace mps {
@@ -17,44 +20,117 @@ NDN_LOG_INIT(ndnmps.blssigner);
 const time::milliseconds TIMEOUT = time::seconds(4);
 const time::milliseconds ESTIMATE_PROCESS_TIME = time::seconds(1);
 const static Name HMAC_KEY_PREFIX("/ndn/mps/hmac"); // append request ID when being used
+const size_t MAX_SIGN_REQUEST_PARAMETERS_SIZE = 2048;
+const size_t ECDH_PUB_KEY_SIZE = 65; // uncompressed P-256 point
+const size_t MAX_TOKEN_BUCKETS = 4096;
+
+namespace {
+
+struct SignerMetrics
+{
+  MetricCounter& m_signRequests = Metrics::get().counter("signer.sign_requests");
+  MetricCounter& m_rejectedRequests = Metrics::get().counter("signer.rejected_requests");
+  MetricCounter& m_malformedRequests = Metrics::get().counter("signer.malformed_requests");
+  MetricCounter& m_rateLimitedRequests = Metrics::get().counter("signer.rate_limited_requests");
+  MetricCounter& m_replayedRequests = Metrics::get().counter("signer.replayed_requests");
+  MetricCounter& m_overloadedRequests = Metrics::get().counter("signer.overloaded_requests");
+  MetricCounter& m_expiredRequests = Metrics::get().counter("signer.expired_requests");
+  MetricCounter& m_evictedTickets = Metrics::get().counter("signer.evicted_tickets");
+  MetricCounter& m_signaturePieces = Metrics::get().counter("signer.signature_pieces");
+  LatencyHistogram& m_parameterFetch = Metrics::get().histogram("signer.parameter_fetch");
+  LatencyHistogram& m_signing = Metrics::get().histogram("signer.signing");
+};
+
+SignerMetrics&
+metrics()
+{
+  static SignerMetrics metrics;
+  return metrics;
+}
+
+} // namespace
 
 struct SignRequestState
 {
-  ECDHState m_ecdh;
+  uint64_t m_requestId;
   std::array<uint8_t, 16> m_aesKey;
+  AesGcm128Session m_aes; // keyed with m_aesKey
   ReplyCode m_code;
   Buffer m_signatureValue;
   size_t m_version;
   RegisteredPrefixHandle m_resultPrefixHandle;
-  security::SigningInfo m_hmacSigningInfo;
+  scheduler::EventId m_expiryEvent;
+  size_t m_memory = 0; // the share of the request in BLSSigner::m_requestMemory
+  std::array<uint8_t, 32> m_hmacKey;
+  uint64_t m_traceId = 0; // echoed in the result Data
+  std::string m_track; // the track of the spans of the signer
+  TraceSpan m_fetchSpan; // fetching the parameter and the payload
 };
 
+/**
+ * @brief Estimate the memory held by a request: its state, its signature piece, and the result prefix
+ *        registration and pending fetch that hold it. The ECDH key pair is released once the ACK is sent.
+ */
+size_t
+estimateMemoryUsage(const SignRequestState& state)
+{
+  const size_t registrationOverhead = 512;
+  return sizeof(SignRequestState) + state.m_signatureValue.capacity() + state.m_track.capacity() +
+         registrationOverhead;
+}
+
+/**
+ * @return the key name in the KeyLocator of a signed Interest, or an empty name if there is none.
+ */
+Name
+getKeyLocatorName(const SignatureInfo& info)
+{
+  if (info.hasKeyLocator() && info.getKeyLocator().getType() == ndn::tlv::Name) {
+    return info.getKeyLocator().getName();
+  }
+  return Name();
+}
+
 /**
  * @brief Parse sign request Interest packet's application parameters.
+ * @return true if the request resumes a session with a ticket instead of carrying an ECDH public key.
  */
-void
-parseSignRequestPayload(const Interest& interest, Name& parameterDataName, std::vector<uint8_t>& peerPubKey)
+bool
+parseSignRequestPayload(const Interest& interest, Name& parameterDataName, std::vector<uint8_t>& peerPubKey,
+                        uint64_t& ticketId, uint64_t& ticketCounter)
 {
   const auto& paramBlock = interest.getApplicationParameters();
   paramBlock.parse();
   parameterDataName.wireDecode(paramBlock.get(tlv::ParameterDataName).blockFromValue());
+  if (paramBlock.find(tlv::TicketId) != paramBlock.elements_end()) {
+    ticketId = readNonNegativeInteger(paramBlock.get(tlv::TicketId));
+    ticketCounter = readNonNegativeInteger(paramBlock.get(tlv::TicketCounter));
+    return true;
+  }
   const auto& ecdhBlock = paramBlock.get(tlv::EcdhPub);
+  if (ecdhBlock.value_size() != ECDH_PUB_KEY_SIZE || ecdhBlock.value()[0] != 0x04) {
+    NDN_THROW(std::runtime_error("ECDH public key is not an uncompressed P-256 point"));
+  }
   peerPubKey.resize(ecdhBlock.value_size());
   std::memcpy(peerPubKey.data(), ecdhBlock.value(), ecdhBlock.value_size());
+  return false;
 }
 
 /**
  * @brief Generate unsigned ACK data.
  */
 Data
-generateSignRequestAck(const Name& interestName, const Name& selfPrefix, ReplyCode code, uint64_t requestId = 0,
-                       const uint8_t* salt = nullptr, const uint8_t* selfPub = nullptr, size_t selfPubSize = 0,
-                       const uint8_t* aesKey = nullptr)
+generateSignRequestAck(const Name& interestName, const Name& selfPrefix, ReplyCode code, uint64_t traceId,
+                       uint64_t requestId = 0, const uint8_t* salt = nullptr, const uint8_t* selfPub = nullptr,
+                       size_t selfPubSize = 0, const uint8_t* aesKey = nullptr, const Block& ticket = Block())
 {
   Data ack(interestName);
   if (code != ReplyCode::Processing) {
     Block contentBlock(ndn::tlv::Content);
-    contentBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::Processing))));
+    contentBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(code))));
+    if (traceId != 0) {
+      contentBlock.push_back(makeNonNegativeIntegerBlock(tlv::TraceId, traceId));
+    }
     ack.setContent(contentBlock);
     ack.setFreshnessPeriod(TIMEOUT);
     return ack;
@@ -64,13 +140,22 @@ generateSignRequestAck(const Name& interestName, const Name& selfPrefix, ReplyCo
   Name newResultName = selfPrefix;
   newResultName.append("mps").append("result").appendNumber(requestId).appendVersion(0);
   unencryptedBlock.push_back(makeNestedBlock(tlv::ResultName, newResultName));
+  if (ticket.isValid()) {
+    unencryptedBlock.push_back(ticket);
+  }
   unencryptedBlock.encode();
   auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content, aesKey,
                                                  unencryptedBlock.value(), unencryptedBlock.value_size(),
                                                  nullptr, 0);
   encryptedBlock.push_back(makeStringBlock(tlv::Status, std::to_string(static_cast<int>(ReplyCode::Processing))));
-  encryptedBlock.push_back(makeBinaryBlock(tlv::Salt, salt, 32));
-  encryptedBlock.push_back(makeBinaryBlock(tlv::EcdhPub, selfPub, selfPubSize));
+  if (salt != nullptr) {
+    // resumed requests derive their keys from the ticket, so there is no key exchange in the ACK
+    encryptedBlock.push_back(makeBinaryBlock(tlv::Salt, salt, 32));
+    encryptedBlock.push_back(makeBinaryBlock(tlv::EcdhPub, selfPub, selfPubSize));
+  }
+  if (traceId != 0) {
+    encryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::TraceId, traceId));
+  }
   encryptedBlock.encode();
   ack.setContent(encryptedBlock);
   ack.setFreshnessPeriod(TIMEOUT);
@@ -94,31 +179,35 @@ generateResultData(const Name& interestName, const Name& resultPrefix, std::shar
     unencryptedBlock.push_back(makeBinaryBlock(tlv::BLSSigValue,
                                                statePtr->m_signatureValue.data(),
                                                statePtr->m_signatureValue.size()));
-    std::cout << "signature value length: " << statePtr->m_signatureValue.size() << std::endl;
-    statePtr->m_resultPrefixHandle.cancel();
-  }
-  else {
-    statePtr->m_resultPrefixHandle.cancel();
   }
   unencryptedBlock.encode();
-  auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content, statePtr->m_aesKey.data(),
+  auto encryptedBlock = encodeBlockWithAesGcm128(ndn::tlv::Content, statePtr->m_aes,
                                                  unencryptedBlock.value(), unencryptedBlock.value_size(),
                                                  nullptr, 0);
+  if (statePtr->m_traceId != 0) {
+    encryptedBlock.push_back(makeNonNegativeIntegerBlock(tlv::TraceId, statePtr->m_traceId));
+    encryptedBlock.encode();
+  }
   result.setContent(encryptedBlock);
   result.setFreshnessPeriod(TIMEOUT);
   return result;
 }
 
-Data
+/**
+ * @brief Decrypt the parameter Data content.
+ * @return the unsigned Data, or a PayloadKey block when the initiator encrypts the payload once per session.
+ */
+Block
 parseParameterData(const Data& data, std::shared_ptr<SignRequestState> statePtr)
 {
-  auto contentBlock = data.getContent();
-  contentBlock.parse();
-  Block dataBlock(std::make_shared<Buffer>(decodeBlockWithAesGcm128(contentBlock,
-                                                                    statePtr->m_aesKey.data(),
-                                                                    nullptr, 0)));
-  Data unsignedData(dataBlock);
-  return unsignedData;
+  // the content is copied once and decrypted in place; the returned block shares that buffer
+  const auto& contentBlock = data.getContent();
+  auto buffer = std::make_shared<Buffer>(contentBlock.begin(), contentBlock.end());
+  size_t offset = 0;
+  size_t size = 0;
+  std::tie(offset, size) = decryptBlockWithAesGcm128InPlace(buffer->data(), buffer->size(), statePtr->m_aes,
+                                                            nullptr, 0);
+  return Block(buffer, buffer->cbegin() + offset, buffer->cbegin() + offset + size);
 }
 
 void
@@ -135,19 +224,15 @@ BLSSigner::BLSSigner(const Name& prefix, Face& face, KeyChain& keyChain,
   , m_keyChain(keyChain)
     , m_keyName(keyName)
     , m_face(face)
+    , m_scheduler(face.getIoService())
     , m_verifyToBeSignedCallback(verifyToBeSignedCallback)
     , m_verifySignRequestCallback(verifySignRequestCallback)
 {
   // generate default key randomly
   ndnBLSInit();
-  auto begin = std::chrono::steady_clock::now();
   blsSecretKeySetByCSPRNG(&m_sk);
-  auto end = std::chrono::steady_clock::now();
-  std::cout << "Signer generating key pair: "
-            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-            << "[µs]" << std::endl;
-  
   blsGetPublicKey(&m_pk, &m_sk);
+  m_unverifiedBucket = TokenBucket{m_unverifiedRequestBurst, time::steady_clock::now()};
   if (m_keyName.empty()) {
     m_keyName = m_prefix;
     m_keyName.append("KEY").appendTimestamp();
@@ -163,56 +248,144 @@ BLSSigner::BLSSigner(const Name& prefix, Face& face, KeyChain& keyChain,
 BLSSigner::~BLSSigner()
 {
   m_signRequestHandle.unregister();
+  // the result filters capture this signer
+  for (auto& item : m_requests) {
+    item.second->m_resultPrefixHandle.cancel();
+  }
+}
+
+void
+BLSSigner::setSecretKey(const BLSSecretKey& sk)
+{
+  m_sk = sk;
+  blsGetPublicKey(&m_pk, &m_sk);
 }
 
 void
 BLSSigner::onSignRequest(const Interest& interest)
 {
-  std::cout << "\n\nSigner: On sign request Interest: " << interest.getName().toUri() << std::endl;
+  NDN_LOG_TRACE("On sign request Interest: " << interest.getName());
+  metrics().m_signRequests.increment();
+  auto traceId = readTraceId(interest.getApplicationParameters());
+  auto track = traceId != 0 ? "signer " + m_prefix.toUri() : std::string();
+  TraceSpan span("on_sign_request", traceId, track);
 
-  if (!m_verifySignRequestCallback(interest) || !interest.isParametersDigestValid()) {
-    auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Unauthorized);
-    ndnBLSSign(m_sk, ack, m_keyName);
-    m_face.put(ack);
-    return;
-  }
-  // parse
+  // syntactic checks: /<signer prefix>/mps/sign/<parameters digest>
   Name parameterDataName;
   std::vector<uint8_t> peerPubKey;
+  uint64_t ticketId = 0;
+  uint64_t ticketCounter = 0;
+  bool isResumed = false;
   try {
-    parseSignRequestPayload(interest, parameterDataName, peerPubKey);
+    const auto& name = interest.getName();
+    if (name.size() != m_prefix.size() + 3 || !name.get(-1).isParametersSha256Digest() ||
+        interest.getApplicationParameters().size() > MAX_SIGN_REQUEST_PARAMETERS_SIZE) {
+      NDN_THROW(std::runtime_error("Unexpected sign request format"));
+    }
+    isResumed = parseSignRequestPayload(interest, parameterDataName, peerPubKey, ticketId, ticketCounter);
+    if (!interest.isParametersDigestValid()) {
+      NDN_THROW(std::runtime_error("Wrong parameters digest"));
+    }
   }
   catch (const std::exception& e) {
-    auto ack = generateSignRequestAck(interest.getName(), m_prefix,ReplyCode::Unauthorized);
-    ndnBLSSign(m_sk, ack, m_keyName);
-    m_face.put(ack);
+    NDN_LOG_DEBUG("Dropped malformed sign request " << interest.getName() << ": " << e.what());
+    metrics().m_malformedRequests.increment();
+    span.end({{"status", "malformed"}});
+    return;
+  }
+
+  // rate limit of all the unverified requests, since their KeyLocators can be forged
+  auto signatureInfo = interest.getSignatureInfo();
+  auto initiatorKeyName = signatureInfo ? getKeyLocatorName(*signatureInfo) : Name();
+  if (m_unverifiedRequestRate > 0 &&
+      !m_unverifiedBucket.take(m_unverifiedRequestRate, m_unverifiedRequestBurst, time::steady_clock::now())) {
+    NDN_LOG_DEBUG("Dropped sign request from " << initiatorKeyName << " over the shared rate limit");
+    metrics().m_rateLimitedRequests.increment();
+    span.end({{"status", "rate_limited"}});
+    return;
+  }
+
+  // replay window
+  bool isReplayChecked = m_replayWindow > time::milliseconds::zero();
+  if (isReplayChecked && (!signatureInfo || !isFreshRequest(*signatureInfo))) {
+    NDN_LOG_INFO("Dropped replayed or stale sign request from " << initiatorKeyName);
+    metrics().m_replayedRequests.increment();
+    span.end({{"status", "replayed"}});
+    return;
+  }
+
+  // signature verification
+  if (!m_verifySignRequestCallback(interest)) {
+    metrics().m_rejectedRequests.increment();
+    span.end({{"status", "unauthorized"}});
+    putRejectionAck(interest, ReplyCode::Unauthorized, traceId);
+    return;
+  }
+  // rate limit of the verified initiator
+  if (!takeRequestToken(initiatorKeyName)) {
+    NDN_LOG_DEBUG("Dropped sign request from " << initiatorKeyName << " over the rate limit");
+    metrics().m_rateLimitedRequests.increment();
+    span.end({{"status", "rate_limited"}});
+    return;
+  }
+  if (isReplayChecked && !rememberNonce(*signatureInfo)) {
+    NDN_LOG_INFO("Replay cache is full, dropped sign request from " << initiatorKeyName);
+    metrics().m_overloadedRequests.increment();
+    span.end({{"status", "overloaded"}});
     return;
   }
   // generate state for the request
   auto statePtr = std::make_shared<SignRequestState>();
   statePtr->m_code = ReplyCode::Processing;
   statePtr->m_version = 0;
-  // ECDH
-  auto dhSecret = statePtr->m_ecdh.deriveSecret(peerPubKey);
+  statePtr->m_traceId = traceId;
+  statePtr->m_track = track;
+  // shed load before any key exchange or ticket is spent on the request
+  if (m_requests.size() >= m_maxRequests ||
+      m_requestMemory + estimateMemoryUsage(*statePtr) > m_maxRequestMemory) {
+    NDN_LOG_INFO("Overloaded with " << m_requests.size() << " requests, rejected " << interest.getName());
+    metrics().m_overloadedRequests.increment();
+    span.end({{"status", "overloaded"}});
+    putRejectionAck(interest, ReplyCode::Unavailable, traceId);
+    return;
+  }
+  std::unique_ptr<ECDHState> ecdh; // not used by resumed requests
   std::array<uint8_t, 32> salt;
-  random::generateSecureBytes(salt.data(), salt.size());
-  std::array<uint8_t, 48> aesAndHmac;
-  hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
+  std::array<uint8_t, 80> aesAndHmac; // AES key | HMAC key | resumption secret
+  Block ticket;
+  if (isResumed) {
+    if (!useTicket(ticketId, ticketCounter, aesAndHmac.data())) {
+      NDN_LOG_INFO("Rejected resumption ticket " << ticketId);
+      metrics().m_rejectedRequests.increment();
+      span.end({{"status", "rejected_ticket"}});
+      putRejectionAck(interest, ReplyCode::Unauthorized, traceId);
+      return;
+    }
+  }
+  else {
+    // ECDH
+    ecdh = make_unique<ECDHState>(m_ecdhKeyPool.get());
+    auto dhSecret = ecdh->deriveSecret(peerPubKey);
+    random::generateSecureBytes(salt.data(), salt.size());
+    hkdf(dhSecret.data(), dhSecret.size(), salt.data(), salt.size(), aesAndHmac.data(), aesAndHmac.size());
+    if (m_ticketLifetime > time::milliseconds(0)) {
+      ticket = issueTicket(aesAndHmac.data() + 48);
+    }
+  }
   std::memcpy(statePtr->m_aesKey.data(), aesAndHmac.data(), 16);
-  auto hmacKeyStr = base64EncodeFromBytes(aesAndHmac.data() + 16, 32, false);
+  statePtr->m_aes.setKey(statePtr->m_aesKey.data());
   // HMAC
-  statePtr->m_hmacSigningInfo.setSigningHmacKey(hmacKeyStr);
-  statePtr->m_hmacSigningInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
-  statePtr->m_hmacSigningInfo.setSignedInterestFormat(security::SignedInterestFormat::V03);
+  std::memcpy(statePtr->m_hmacKey.data(), aesAndHmac.data() + 16, 32);
 
   auto requestId = random::generateSecureWord64();
+  statePtr->m_requestId = requestId;
   Name resultPrefix = m_prefix;
   resultPrefix.append("mps").append("result").appendNumber(requestId);
   statePtr->m_resultPrefixHandle = m_face.setInterestFilter(
     resultPrefix,
     [this, statePtr, resultPrefix](const auto&, const auto& interest)
     {
-      std::cout << "\n\nSigner: received result fetch Interest: " << interest.getName().toUri() << std::endl;
+      NDN_LOG_TRACE("Received result fetch Interest: " << interest.getName());
       // parse request: /signer/mps/result/randomness/version/hash
       // TODO: signature verification
       if (interest.getName().size() != m_prefix.size() + 5) {
@@ -220,70 +393,318 @@ BLSSigner::onSignRequest(const Interest& interest)
         return;
       }
       auto result = generateResultData(interest.getName(), resultPrefix, statePtr);
-      m_keyChain.sign(result, statePtr->m_hmacSigningInfo);
+      signDataWithHmacSha256(result, statePtr->m_hmacKey.data(), statePtr->m_hmacKey.size());
       m_face.put(result);
+      if (statePtr->m_code != ReplyCode::Processing) {
+        // the final result has been delivered
+        removeRequest(statePtr->m_requestId);
+      }
     },
     nullptr, onRegisterFail);
+  m_requests.emplace(requestId, statePtr);
+  updateRequestMemory(*statePtr);
+  statePtr->m_expiryEvent = m_scheduler.schedule(m_requestLifetime, [this, requestId] {
+    NDN_LOG_DEBUG("Request " << requestId << " expired");
+    metrics().m_expiredRequests.increment();
+    removeRequest(requestId);
+  });
 
-  auto selfPubKey = statePtr->m_ecdh.getSelfPubKey();
-  auto ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, requestId,
-                                    salt.data(), selfPubKey.data(), selfPubKey.size(), statePtr->m_aesKey.data());
+  Data ack;
+  if (isResumed) {
+    ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, traceId, requestId,
+                                 nullptr, nullptr, 0, statePtr->m_aesKey.data());
+  }
+  else {
+    auto selfPubKey = ecdh->getSelfPubKey();
+    ack = generateSignRequestAck(interest.getName(), m_prefix, ReplyCode::Processing, traceId, requestId,
+                                 salt.data(), selfPubKey.data(), selfPubKey.size(), statePtr->m_aesKey.data(), ticket);
+  }
   ndnBLSSign(m_sk, ack, m_keyName);
   m_face.put(ack);
+  span.end({{"status", "processing"}, {"resumed", isResumed ? "true" : "false"}});
 
   // fetch parameter
   Interest fetchInterest(parameterDataName);
   fetchInterest.setCanBePrefix(true);
   fetchInterest.setMustBeFresh(true);
   fetchInterest.setInterestLifetime(TIMEOUT);
-  std::cout << "\n\nSigner: send Interest to fetch parameter: " << parameterDataName.toUri() << std::endl;
+  NDN_LOG_TRACE("Send Interest to fetch parameter: " << parameterDataName);
+  std::chrono::steady_clock::time_point fetchBegin;
+  if (Metrics::isEnabled()) {
+    fetchBegin = std::chrono::steady_clock::now();
+  }
+  statePtr->m_fetchSpan = TraceSpan("parameter_fetch", traceId, track);
   m_face.expressInterest(
     fetchInterest,
     [=](const auto& interest, const auto& data)
     {
-      std::cout << "\n\nSigner: fetched parameter Data packet." << std::endl << data;
-      if (!security::verifySignature(data, m_keyChain.getTpm(),
-                                    statePtr->m_hmacSigningInfo.getSignerName(),
-                                    DigestAlgorithm::SHA256)) {
-        std::cout << "Signer: HMAC verification failed" << std::endl;
+      metrics().m_parameterFetch.recordSince(fetchBegin);
+      NDN_LOG_TRACE("Fetched parameter Data: " << data.getName());
+      if (!verifyDataWithHmacSha256(data, statePtr->m_hmacKey.data(), statePtr->m_hmacKey.size())) {
+        NDN_LOG_INFO("HMAC verification of parameter Data failed");
         return;
       }
       Data unsignedData;
       try {
-        unsignedData = parseParameterData(data, statePtr);
+        auto parameter = parseParameterData(data, statePtr);
+        if (parameter.type() == tlv::PayloadKey) {
+          fetchPayloadData(parameter, statePtr);
+          return;
+        }
+        unsignedData.wireDecode(parameter);
       }
       catch (const std::exception& e) {
         NDN_LOG_ERROR("Unsigned Data decoding error");
         statePtr->m_code = ReplyCode::FailedDependency;
         return;
       }
-      if (!m_verifyToBeSignedCallback(unsignedData)) {
-        NDN_LOG_ERROR("Unsigned Data verification error");
-        statePtr->m_code = ReplyCode::Unauthorized;
-        return;
-      }
-      // generate result
-      std::cout << "Signer: result status code is OK " << std::endl;
-      statePtr->m_code = ReplyCode::OK;
-      auto begin = std::chrono::steady_clock::now();
-      statePtr->m_signatureValue = ndnGenBLSSignature(m_sk, unsignedData);
-      auto end = std::chrono::steady_clock::now();
-      std::cout << "Signer generating signature piece: "
-                << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-                << "[µs]" << std::endl;
-      std::cout << "signature value length: " << statePtr->m_signatureValue.size() << std::endl;
+      onUnsignedData(unsignedData, statePtr);
     },
     [=](auto& interest, auto&)
     {
       // nack
       statePtr->m_code = ReplyCode::FailedDependency;
+      statePtr->m_fetchSpan.end({{"status", "nack"}});
     },
     [=](auto& interest)
     {
       // timeout
       statePtr->m_code = ReplyCode::FailedDependency;
+      statePtr->m_fetchSpan.end({{"status", "timeout"}});
+    });
+}
+
+Block
+BLSSigner::issueTicket(const uint8_t* resumptionSecret)
+{
+  auto now = time::steady_clock::now();
+  auto oldest = m_tickets.end();
+  for (auto it = m_tickets.begin(); it != m_tickets.end();) {
+    if (it->second.m_expiry <= now) {
+      it = m_tickets.erase(it);
+    }
+    else {
+      if (oldest == m_tickets.end() || it->second.m_expiry < oldest->second.m_expiry) {
+        oldest = it;
+      }
+      it++;
+    }
+  }
+  // the tickets are issued with the same lifetime, so the oldest one expires first
+  if (m_tickets.size() >= m_maxTickets && oldest != m_tickets.end()) {
+    m_tickets.erase(oldest);
+    metrics().m_evictedTickets.increment();
+  }
+  auto ticketId = random::generateSecureWord64();
+  auto& ticket = m_tickets[ticketId];
+  std::memcpy(ticket.m_secret.data(), resumptionSecret, ticket.m_secret.size());
+  ticket.m_expiry = now + m_ticketLifetime;
+  ticket.m_remainingRequests = m_ticketRequestBudget;
+  ticket.m_lastCounter = 0;
+
+  Block ticketBlock(tlv::Ticket);
+  ticketBlock.push_back(makeNonNegativeIntegerBlock(tlv::TicketId, ticketId));
+  ticketBlock.push_back(makeNonNegativeIntegerBlock(tlv::TicketLifetime, m_ticketLifetime.count()));
+  ticketBlock.push_back(makeNonNegativeIntegerBlock(tlv::TicketBudget, m_ticketRequestBudget));
+  ticketBlock.encode();
+  return ticketBlock;
+}
+
+bool
+BLSSigner::useTicket(uint64_t ticketId, uint64_t ticketCounter, uint8_t* keys)
+{
+  auto it = m_tickets.find(ticketId);
+  if (it == m_tickets.end()) {
+    return false;
+  }
+  auto& ticket = it->second;
+  if (ticket.m_expiry <= time::steady_clock::now() || ticket.m_remainingRequests == 0) {
+    m_tickets.erase(it);
+    return false;
+  }
+  if (ticketCounter <= ticket.m_lastCounter) {
+    // replayed request
+    return false;
+  }
+  ticket.m_lastCounter = ticketCounter;
+  ticket.m_remainingRequests--;
+  deriveResumedKeys(ticket.m_secret.data(), ticket.m_secret.size(), ticketId, ticketCounter, keys, 48);
+  return true;
+}
+
+void
+BLSSigner::putRejectionAck(const Interest& interest, ReplyCode code, uint64_t traceId)
+{
+  auto ack = generateSignRequestAck(interest.getName(), m_prefix, code, traceId);
+  m_keyChain.sign(ack, signingWithSha256());
+  m_face.put(ack);
+}
+
+void
+BLSSigner::fetchPayloadData(const Block& payloadKey, std::shared_ptr<SignRequestState> statePtr)
+{
+  payloadKey.parse();
+  const auto& contentKeyBlock = payloadKey.get(tlv::ContentKey);
+  if (contentKeyBlock.value_size() != 16) {
+    NDN_THROW(std::runtime_error("Content key is of an unexpected size"));
+  }
+  std::array<uint8_t, 16> contentKey;
+  std::memcpy(contentKey.data(), contentKeyBlock.value(), contentKey.size());
+  Name payloadName(payloadKey.get(tlv::PayloadName).blockFromValue());
+
+  // the name ends with the implicit digest, so the payload can come from any cache
+  Interest fetchInterest(payloadName);
+  fetchInterest.setCanBePrefix(false);
+  fetchInterest.setInterestLifetime(TIMEOUT);
+  NDN_LOG_TRACE("Send Interest to fetch payload: " << payloadName);
+  m_face.expressInterest(
+    fetchInterest,
+    [=](const auto&, const auto& data)
+    {
+      Data unsignedData;
+      try {
+        if (data.getFullName() != payloadName) {
+          NDN_THROW(std::runtime_error("Payload Data does not match the implicit digest"));
+        }
+        auto decrypted = decodeBlockWithAesGcm128(data.getContent(), contentKey.data(), nullptr, 0);
+        unsignedData.wireDecode(Block(std::make_shared<Buffer>(std::move(decrypted))));
+      }
+      catch (const std::exception& e) {
+        NDN_LOG_ERROR("Payload Data decoding error: " << e.what());
+        statePtr->m_code = ReplyCode::FailedDependency;
+        return;
+      }
+      onUnsignedData(unsignedData, statePtr);
+    },
+    [=](auto&, auto&)
+    {
+      // nack
+      statePtr->m_code = ReplyCode::FailedDependency;
+      statePtr->m_fetchSpan.end({{"status", "nack"}});
+    },
+    [=](auto&)
+    {
+      // timeout
+      statePtr->m_code = ReplyCode::FailedDependency;
+      statePtr->m_fetchSpan.end({{"status", "timeout"}});
     });
 }
 
+void
+BLSSigner::onUnsignedData(const Data& unsignedData, std::shared_ptr<SignRequestState> statePtr)
+{
+  // the parameter, and the payload if any, has been fetched
+  statePtr->m_fetchSpan.end();
+  if (m_requests.count(statePtr->m_requestId) == 0) {
+    NDN_LOG_DEBUG("Request " << statePtr->m_requestId << " expired before its parameter was fetched");
+    return;
+  }
+  if (!m_verifyToBeSignedCallback(unsignedData)) {
+    NDN_LOG_ERROR("Unsigned Data verification error");
+    statePtr->m_code = ReplyCode::Unauthorized;
+    return;
+  }
+  // generate result
+  statePtr->m_code = ReplyCode::OK;
+  {
+    ScopedTimer timer(metrics().m_signing);
+    TraceSpan span("signing", statePtr->m_traceId, statePtr->m_track);
+    statePtr->m_signatureValue = ndnGenBLSSignature(m_sk, unsignedData);
+  }
+  updateRequestMemory(*statePtr);
+  metrics().m_signaturePieces.increment();
+  NDN_LOG_DEBUG("Generated signature piece for " << unsignedData.getName());
+}
+
+bool
+BLSSigner::TokenBucket::take(double rate, double burst, const time::steady_clock::TimePoint& now)
+{
+  time::duration<double> elapsed = now - m_lastUpdate;
+  m_tokens = std::min(burst, m_tokens + elapsed.count() * rate);
+  m_lastUpdate = now;
+  if (m_tokens < 1) {
+    return false;
+  }
+  m_tokens -= 1;
+  return true;
+}
+
+bool
+BLSSigner::takeRequestToken(const Name& initiatorKeyName)
+{
+  if (m_requestRate <= 0) {
+    return true;
+  }
+  auto now = time::steady_clock::now();
+  auto it = m_tokenBucketIndex.find(initiatorKeyName);
+  if (it == m_tokenBucketIndex.end()) {
+    m_tokenBuckets.emplace_front(initiatorKeyName, TokenBucket{m_requestBurst, now});
+    it = m_tokenBucketIndex.emplace(initiatorKeyName, m_tokenBuckets.begin()).first;
+    if (m_tokenBuckets.size() > MAX_TOKEN_BUCKETS) {
+      m_tokenBucketIndex.erase(m_tokenBuckets.back().first);
+      m_tokenBuckets.pop_back();
+    }
+  }
+  else {
+    m_tokenBuckets.splice(m_tokenBuckets.begin(), m_tokenBuckets, it->second);
+  }
+  return it->second->second.take(m_requestRate, m_requestBurst, now);
+}
+
+bool
+BLSSigner::isFreshRequest(const SignatureInfo& info) const
+{
+  auto timestamp = info.getTime();
+  auto nonce = info.getNonce();
+  if (!timestamp || !nonce) {
+    return false;
+  }
+  // open on both ends, so a timestamp leaves the window no later than the nonce leaves m_seenNonces
+  auto now = time::system_clock::now();
+  if (*timestamp <= now - m_replayWindow || *timestamp >= now + m_replayWindow) {
+    return false;
+  }
+  return m_seenNonces.count(NonceKey(getKeyLocatorName(info), *nonce)) == 0;
+}
+
+bool
+BLSSigner::rememberNonce(const SignatureInfo& info)
+{
+  auto now = time::steady_clock::now();
+  while (!m_nonceExpiry.empty() && m_nonceExpiry.front().first <= now) {
+    m_seenNonces.erase(m_nonceExpiry.front().second);
+    m_nonceExpiry.pop_front();
+  }
+  if (m_seenNonces.size() >= m_maxSeenNonces) {
+    return false;
+  }
+  NonceKey key(getKeyLocatorName(info), *info.getNonce());
+  m_seenNonces.insert(key);
+  m_nonceExpiry.emplace_back(now + 2 * m_replayWindow, std::move(key));
+  return true;
+}
+
+void
+BLSSigner::removeRequest(uint64_t requestId)
+{
+  auto it = m_requests.find(requestId);
+  if (it == m_requests.end()) {
+    return;
+  }
+  auto& state = *it->second;
+  state.m_resultPrefixHandle.cancel();
+  state.m_expiryEvent.cancel();
+  m_requestMemory -= state.m_memory;
+  m_requests.erase(it);
+}
+
+void
+BLSSigner::updateRequestMemory(SignRequestState& state)
+{
+  auto memory = estimateMemoryUsage(state);
+  m_requestMemory = m_requestMemory - state.m_memory + memory;
+  state.m_memory = memory;
+}
+
 }  // namespace mps
 }  // namespace ndn
\ No newline at end of file
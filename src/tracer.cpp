@@ -0,0 +1,242 @@
+#include "ndnmps/tracer.hpp"
+
+#include <ndn-cxx/util/random.hpp>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace ndn {
+namespace mps {
+
+std::atomic<bool> Tracer::s_isEnabled{false};
+
+static int64_t
+toMicroseconds(std::chrono::steady_clock::time_point timePoint)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(timePoint.time_since_epoch()).count();
+}
+
+static std::string
+escapeJson(const std::string& str)
+{
+  std::ostringstream os;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }
+        else {
+          os << c;
+        }
+    }
+  }
+  return os.str();
+}
+
+Tracer&
+Tracer::get()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+uint64_t
+Tracer::newTraceId()
+{
+  if (!isEnabled()) {
+    return 0;
+  }
+  uint64_t traceId = 0;
+  while (traceId == 0) {
+    traceId = random::generateWord64();
+  }
+  return traceId;
+}
+
+void
+Tracer::addCompleteEvent(const std::string& name, uint64_t traceId, const std::string& track,
+                         std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end,
+                         std::map<std::string, std::string> args)
+{
+  if (!isEnabled() || traceId == 0) {
+    return;
+  }
+  addEvent(Event{name, traceId, track, 'X', toMicroseconds(begin), toMicroseconds(end) - toMicroseconds(begin),
+                 std::move(args)});
+}
+
+void
+Tracer::addInstantEvent(const std::string& name, uint64_t traceId, const std::string& track,
+                        std::map<std::string, std::string> args)
+{
+  if (!isEnabled() || traceId == 0) {
+    return;
+  }
+  addEvent(Event{name, traceId, track, 'i', toMicroseconds(std::chrono::steady_clock::now()), 0,
+                 std::move(args)});
+}
+
+void
+Tracer::addEvent(Event&& event)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_events.size() < m_maxEvents) {
+    m_events.push_back(std::move(event));
+  }
+}
+
+std::vector<Tracer::Event>
+Tracer::getEvents() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_events;
+}
+
+void
+Tracer::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_events.clear();
+}
+
+void
+Tracer::writeChromeTrace(std::ostream& os) const
+{
+  auto events = getEvents();
+  // sessions are shown as processes and players as their threads, both numbered in order of appearance
+  std::map<uint64_t, size_t> pids;
+  std::map<std::string, size_t> tids;
+  std::map<std::pair<size_t, size_t>, std::string> threadNames;
+  for (const auto& event : events) {
+    auto pid = pids.emplace(event.m_traceId, pids.size() + 1).first->second;
+    auto tid = tids.emplace(event.m_track, tids.size() + 1).first->second;
+    threadNames.emplace(std::make_pair(pid, tid), event.m_track);
+  }
+
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool isFirst = true;
+  for (const auto& item : pids) {
+    os << (isFirst ? "\n" : ",\n")
+       << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << item.second
+       << ", \"args\": {\"name\": \"session " << std::hex << item.first << std::dec << "\"}}";
+    isFirst = false;
+  }
+  for (const auto& item : threadNames) {
+    os << (isFirst ? "\n" : ",\n")
+       << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << item.first.first
+       << ", \"tid\": " << item.first.second
+       << ", \"args\": {\"name\": \"" << escapeJson(item.second) << "\"}}";
+    isFirst = false;
+  }
+  for (const auto& event : events) {
+    os << (isFirst ? "\n" : ",\n")
+       << "{\"name\": \"" << escapeJson(event.m_name) << "\", \"cat\": \"ndnmps\""
+       << ", \"ph\": \"" << event.m_phase << "\""
+       << ", \"ts\": " << event.m_timestamp;
+    if (event.m_phase == 'X') {
+      os << ", \"dur\": " << event.m_duration;
+    }
+    else {
+      os << ", \"s\": \"t\"";
+    }
+    os << ", \"pid\": " << pids[event.m_traceId]
+       << ", \"tid\": " << tids[event.m_track]
+       << ", \"args\": {";
+    bool isFirstArg = true;
+    for (const auto& arg : event.m_args) {
+      os << (isFirstArg ? "" : ", ") << "\"" << escapeJson(arg.first) << "\": \"" << escapeJson(arg.second) << "\"";
+      isFirstArg = false;
+    }
+    os << "}}";
+    isFirst = false;
+  }
+  os << "\n]}\n";
+}
+
+void
+Tracer::writeChromeTrace(const std::string& fileName) const
+{
+  std::ofstream file(fileName);
+  if (!file) {
+    NDN_THROW(std::runtime_error("Cannot open the trace file " + fileName));
+  }
+  writeChromeTrace(file);
+  if (!file) {
+    NDN_THROW(std::runtime_error("Cannot write the trace file " + fileName));
+  }
+}
+
+TraceSpan::TraceSpan(std::string name, uint64_t traceId, std::string track)
+{
+  if (Tracer::isEnabled() && traceId != 0) {
+    m_name = std::move(name);
+    m_traceId = traceId;
+    m_track = std::move(track);
+    m_begin = std::chrono::steady_clock::now();
+  }
+}
+
+TraceSpan::TraceSpan(TraceSpan&& other)
+  : m_name(std::move(other.m_name))
+  , m_traceId(other.m_traceId)
+  , m_track(std::move(other.m_track))
+  , m_begin(other.m_begin)
+{
+  other.m_traceId = 0;
+}
+
+TraceSpan&
+TraceSpan::operator=(TraceSpan&& other)
+{
+  if (this != &other) {
+    end();
+    m_name = std::move(other.m_name);
+    m_traceId = other.m_traceId;
+    m_track = std::move(other.m_track);
+    m_begin = other.m_begin;
+    other.m_traceId = 0;
+  }
+  return *this;
+}
+
+TraceSpan::~TraceSpan()
+{
+  end();
+}
+
+void
+TraceSpan::end(std::map<std::string, std::string> args)
+{
+  if (m_traceId == 0) {
+    return;
+  }
+  Tracer::get().addCompleteEvent(m_name, m_traceId, m_track, m_begin, std::chrono::steady_clock::now(),
+                                 std::move(args));
+  m_traceId = 0;
+}
+
+uint64_t
+readTraceId(const Block& block)
+{
+  try {
+    block.parse();
+    auto it = block.find(tlv::TraceId);
+    return it == block.elements_end() ? 0 : readNonNegativeInteger(*it);
+  }
+  catch (const ndn::tlv::Error&) {
+    return 0;
+  }
+}
+
+}  // namespace mps
+}  // namespace ndn
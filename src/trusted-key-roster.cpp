@@ -0,0 +1,394 @@
+#include "ndnmps/trusted-key-roster.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include <ndn-cxx/util/sha256.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace mps {
+
+const size_t TrustedKeyRoster::npos = std::numeric_limits<size_t>::max();
+
+const static uint8_t ROSTER_MAGIC[] = {'N', 'D', 'N', 'M', 'P', 'S', 'R', 'S'};
+const static uint32_t ROSTER_FORMAT_VERSION = 1;
+const static size_t ROSTER_HEADER_SIZE = 24;
+const static size_t PUBLIC_KEY_SIZE = 48;
+const static size_t POP_SIZE = 96;
+const static size_t MIN_NAME_SIZE = 2; // an empty Name TLV
+
+static void
+writeBigEndian(std::ostream& os, uint64_t value, size_t size)
+{
+  for (size_t i = size; i > 0; i--) {
+    os.put(static_cast<char>((value >> (8 * (i - 1))) & 0xFF));
+  }
+}
+
+static uint64_t
+readBigEndian(const uint8_t* buf, size_t size)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value = (value << 8) | buf[i];
+  }
+  return value;
+}
+
+void
+TrustedKeyRoster::writeRoster(const std::string& fileName, std::vector<Entry> entries, uint64_t rosterVersion)
+{
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) { return lhs.m_keyName < rhs.m_keyName; });
+  std::ofstream os(fileName, std::ios::binary | std::ios::trunc);
+  if (!os) {
+    NDN_THROW(std::runtime_error("Cannot open roster file " + fileName));
+  }
+  os.write(reinterpret_cast<const char*>(ROSTER_MAGIC), sizeof(ROSTER_MAGIC));
+  writeBigEndian(os, ROSTER_FORMAT_VERSION, 4);
+  writeBigEndian(os, entries.size(), 4);
+  writeBigEndian(os, rosterVersion, 8);
+
+  uint8_t buf[POP_SIZE];
+  for (const auto& entry : entries) {
+    const auto& nameWire = entry.m_keyName.wireEncode();
+    os.write(reinterpret_cast<const char*>(nameWire.wire()), nameWire.size());
+    if (blsPublicKeySerialize(buf, sizeof(buf), &entry.m_publicKey) != PUBLIC_KEY_SIZE) {
+      NDN_THROW(std::runtime_error("Cannot serialize public key of " + entry.m_keyName.toUri()));
+    }
+    os.write(reinterpret_cast<const char*>(buf), PUBLIC_KEY_SIZE);
+    if (blsSignatureSerialize(buf, sizeof(buf), &entry.m_proofOfPossession) != POP_SIZE) {
+      NDN_THROW(std::runtime_error("Cannot serialize proof of possession of " + entry.m_keyName.toUri()));
+    }
+    os.write(reinterpret_cast<const char*>(buf), POP_SIZE);
+  }
+  if (!os.flush()) {
+    NDN_THROW(std::runtime_error("Cannot write roster file " + fileName));
+  }
+}
+
+TrustedKeyRoster::TrustedKeyRoster(const std::string& fileName)
+{
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    NDN_THROW(std::runtime_error("Cannot open roster file " + fileName));
+  }
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < ROSTER_HEADER_SIZE) {
+    ::close(fd);
+    NDN_THROW(std::runtime_error("Roster file " + fileName + " is too short"));
+  }
+  m_mappedSize = static_cast<size_t>(fileStat.st_size);
+  void* mapped = ::mmap(nullptr, m_mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    NDN_THROW(std::runtime_error("Cannot map roster file " + fileName));
+  }
+  m_base = static_cast<const uint8_t*>(mapped);
+
+  try {
+    if (std::memcmp(m_base, ROSTER_MAGIC, sizeof(ROSTER_MAGIC)) != 0 ||
+        readBigEndian(m_base + 8, 4) != ROSTER_FORMAT_VERSION) {
+      NDN_THROW(std::runtime_error("Unrecognized roster file format"));
+    }
+    auto count = static_cast<size_t>(readBigEndian(m_base + 12, 4));
+    m_version = readBigEndian(m_base + 16, 8);
+    // bound the count by the file size before reserving for it
+    if (count > (m_mappedSize - ROSTER_HEADER_SIZE) / (MIN_NAME_SIZE + PUBLIC_KEY_SIZE + POP_SIZE)) {
+      NDN_THROW(std::runtime_error("Truncated roster record"));
+    }
+
+    // index the key names; the public keys are left in the mapped file
+    m_keyNames.reserve(count);
+    m_keyOffsets.reserve(count);
+    size_t offset = ROSTER_HEADER_SIZE;
+    for (size_t i = 0; i < count; i++) {
+      bool isOk = false;
+      Block nameBlock;
+      std::tie(isOk, nameBlock) = Block::fromBuffer(m_base + offset, m_mappedSize - offset);
+      if (!isOk || nameBlock.type() != ndn::tlv::Name ||
+          m_mappedSize - offset - nameBlock.size() < PUBLIC_KEY_SIZE + POP_SIZE) {
+        NDN_THROW(std::runtime_error("Truncated roster record"));
+      }
+      offset += nameBlock.size();
+      m_keyNames.emplace_back(nameBlock);
+      m_keyOffsets.push_back(offset);
+      offset += PUBLIC_KEY_SIZE + POP_SIZE;
+    }
+
+    // files written by writeRoster are sorted already
+    if (!std::is_sorted(m_keyNames.begin(), m_keyNames.end())) {
+      std::vector<size_t> order(count);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [this](size_t lhs, size_t rhs) { return m_keyNames[lhs] < m_keyNames[rhs]; });
+      std::vector<Name> sortedNames;
+      std::vector<size_t> sortedOffsets;
+      sortedNames.reserve(count);
+      sortedOffsets.reserve(count);
+      for (auto i : order) {
+        sortedNames.push_back(std::move(m_keyNames[i]));
+        sortedOffsets.push_back(m_keyOffsets[i]);
+      }
+      m_keyNames.swap(sortedNames);
+      m_keyOffsets.swap(sortedOffsets);
+    }
+  }
+  catch (const std::exception&) {
+    ::munmap(const_cast<uint8_t*>(m_base), m_mappedSize);
+    throw;
+  }
+  m_publicKeys.resize(m_keyNames.size());
+  m_decodeFlags.reset(new std::once_flag[m_keyNames.size()]);
+}
+
+TrustedKeyRoster::~TrustedKeyRoster()
+{
+  ::munmap(const_cast<uint8_t*>(m_base), m_mappedSize);
+}
+
+size_t
+TrustedKeyRoster::find(const Name& keyName) const
+{
+  auto it = std::lower_bound(m_keyNames.begin(), m_keyNames.end(), keyName);
+  if (it == m_keyNames.end() || *it != keyName) {
+    return npos;
+  }
+  return static_cast<size_t>(it - m_keyNames.begin());
+}
+
+size_t
+TrustedKeyRoster::find(const Block& keyNameWire) const
+{
+  auto it = std::lower_bound(m_keyNames.begin(), m_keyNames.end(), keyNameWire, NameWireCompare());
+  if (it == m_keyNames.end() || compareName(*it, keyNameWire) != 0) {
+    return npos;
+  }
+  return static_cast<size_t>(it - m_keyNames.begin());
+}
+
+const BLSPublicKey&
+TrustedKeyRoster::getPublicKey(size_t index) const
+{
+  if (index >= size()) {
+    NDN_THROW(std::out_of_range("Roster index out of range"));
+  }
+  // a throwing call leaves the flag unset, so a bad key fails on every access
+  std::call_once(m_decodeFlags[index], [this, index] {
+    if (blsPublicKeyDeserialize(&m_publicKeys[index], m_base + m_keyOffsets[index], PUBLIC_KEY_SIZE) == 0) {
+      NDN_THROW(std::runtime_error("Cannot deserialize public key of " + m_keyNames[index].toUri()));
+    }
+  });
+  return m_publicKeys[index];
+}
+
+BLSSignature
+TrustedKeyRoster::getProofOfPossession(size_t index) const
+{
+  BLSSignature pop;
+  if (blsSignatureDeserialize(&pop, m_base + m_keyOffsets.at(index) + PUBLIC_KEY_SIZE, POP_SIZE) == 0) {
+    NDN_THROW(std::runtime_error("Cannot deserialize proof of possession of " + m_keyNames[index].toUri()));
+  }
+  return pop;
+}
+
+std::vector<size_t>
+TrustedKeyRoster::findInvalidProofsOfPossession() const
+{
+  std::vector<size_t> invalidIndexes;
+  std::vector<size_t> candidates;
+  std::vector<BLSPublicKey> pubKeys;
+  std::vector<BLSSignature> pops;
+  std::vector<Buffer> messages;
+  candidates.reserve(size());
+  pubKeys.reserve(size());
+  pops.reserve(size());
+  messages.reserve(size());
+  for (size_t i = 0; i < size(); i++) {
+    BLSPublicKey pubKey;
+    BLSSignature pop;
+    try {
+      pubKey = getPublicKey(i);
+      pop = getProofOfPossession(i);
+    }
+    catch (const std::runtime_error&) {
+      invalidIndexes.push_back(i);
+      continue;
+    }
+    // the proof of possession is the signature over the serialized public key, as blsGetPop makes it
+    candidates.push_back(i);
+    pubKeys.push_back(pubKey);
+    pops.push_back(pop);
+    messages.emplace_back(m_base + m_keyOffsets[i], PUBLIC_KEY_SIZE);
+  }
+  for (auto i : ndnBLSFindInvalidSignatures(pubKeys, pops, messages)) {
+    invalidIndexes.push_back(candidates[i]);
+  }
+  std::sort(invalidIndexes.begin(), invalidIndexes.end());
+  return invalidIndexes;
+}
+
+const Buffer&
+TrustedKeyRoster::getDigest() const
+{
+  std::call_once(m_digestFlag, [this] {
+    util::Sha256 hasher;
+    hasher.update(m_base, m_mappedSize);
+    auto digest = hasher.computeDigest();
+    m_digest.assign(digest->begin(), digest->end());
+  });
+  return m_digest;
+}
+
+static void
+appendVarNumber(Buffer& buf, uint64_t value)
+{
+  if (value < 253) {
+    buf.push_back(static_cast<uint8_t>(value));
+    return;
+  }
+  size_t size = 8;
+  if (value <= 0xFFFF) {
+    buf.push_back(253);
+    size = 2;
+  }
+  else if (value <= 0xFFFFFFFF) {
+    buf.push_back(254);
+    size = 4;
+  }
+  else {
+    buf.push_back(255);
+  }
+  for (size_t i = size; i > 0; i--) {
+    buf.push_back(static_cast<uint8_t>((value >> (8 * (i - 1))) & 0xFF));
+  }
+}
+
+Block
+TrustedKeyRoster::encodeSignerList(const MpsSignerList& signers) const
+{
+  std::vector<size_t> indexes;
+  indexes.reserve(signers.m_signers.size());
+  for (const auto& keyName : signers.m_signers) {
+    auto index = find(keyName);
+    if (index == npos) {
+      NDN_THROW(std::runtime_error("Signer " + keyName.toUri() + " is not in the roster"));
+    }
+    indexes.push_back(index);
+  }
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+  Buffer deltas;
+  for (size_t i = 0; i < indexes.size(); i++) {
+    appendVarNumber(deltas, i == 0 ? indexes[i] : indexes[i] - indexes[i - 1]);
+  }
+  size_t bitmapSize = indexes.empty() ? 0 : indexes.back() / 8 + 1;
+
+  Block wire(tlv::MpsRosterSignerList);
+  wire.push_back(makeNonNegativeIntegerBlock(tlv::RosterVersion, m_version));
+  wire.push_back(makeBinaryBlock(tlv::RosterDigest, getDigest().data(), getDigest().size()));
+  if (bitmapSize <= deltas.size()) {
+    Buffer bitmap(bitmapSize);
+    for (auto index : indexes) {
+      bitmap[index / 8] |= static_cast<uint8_t>(0x80 >> (index % 8));
+    }
+    wire.push_back(makeBinaryBlock(tlv::SignerBitmap, bitmap.data(), bitmap.size()));
+  }
+  else {
+    wire.push_back(makeBinaryBlock(tlv::SignerIndexDeltas, deltas.data(), deltas.size()));
+  }
+  wire.encode();
+  return wire;
+}
+
+std::vector<size_t>
+TrustedKeyRoster::decodeSignerIndexes(const Block& wire) const
+{
+  if (wire.type() != tlv::MpsRosterSignerList) {
+    NDN_THROW(ndn::tlv::Error("MpsRosterSignerList", wire.type()));
+  }
+  wire.parse();
+  const auto& digestBlock = wire.get(tlv::RosterDigest);
+  const auto& digest = getDigest();
+  if (digestBlock.value_size() != digest.size() ||
+      !std::equal(digest.begin(), digest.end(), digestBlock.value())) {
+    NDN_THROW(ndn::tlv::Error("The signer list refers to another roster"));
+  }
+
+  // every index is checked before it is stored, since the block comes from the untrusted signature info Data
+  std::vector<size_t> indexes;
+  auto bitmapIt = wire.find(tlv::SignerBitmap);
+  if (bitmapIt != wire.elements_end()) {
+    const uint8_t* bitmap = bitmapIt->value();
+    for (size_t byte = 0; byte < bitmapIt->value_size(); byte++) {
+      for (size_t bit = 0; bitmap[byte] != 0 && bit < 8; bit++) {
+        if (bitmap[byte] & (0x80 >> bit)) {
+          if (byte * 8 + bit >= size()) {
+            NDN_THROW(ndn::tlv::Error("Signer index out of the roster range"));
+          }
+          indexes.push_back(byte * 8 + bit);
+        }
+      }
+    }
+  }
+  else {
+    const auto& deltaBlock = wire.get(tlv::SignerIndexDeltas);
+    const uint8_t* begin = deltaBlock.value();
+    const uint8_t* end = begin + deltaBlock.value_size();
+    while (begin != end) {
+      auto delta = ndn::tlv::readVarNumber(begin, end);
+      if (!indexes.empty() && delta == 0) {
+        NDN_THROW(ndn::tlv::Error("Signer indexes are not strictly increasing"));
+      }
+      // compared with the room left in the roster, so the sum cannot wrap around
+      if (indexes.empty() ? delta >= size() : delta > size() - 1 - indexes.back()) {
+        NDN_THROW(ndn::tlv::Error("Signer index out of the roster range"));
+      }
+      indexes.push_back(indexes.empty() ? delta : indexes.back() + delta);
+    }
+  }
+  return indexes;
+}
+
+MpsSignerList
+TrustedKeyRoster::decodeSignerList(const Block& wire) const
+{
+  return getSignerList(decodeSignerIndexes(wire));
+}
+
+MpsSignerList
+TrustedKeyRoster::getSignerList(const std::vector<size_t>& indexes) const
+{
+  std::vector<Name> signers;
+  signers.reserve(indexes.size());
+  for (auto index : indexes) {
+    signers.push_back(m_keyNames.at(index));
+  }
+  return MpsSignerList(std::move(signers));
+}
+
+BLSPublicKey
+TrustedKeyRoster::aggregateKey(const std::vector<size_t>& indexes) const
+{
+  if (indexes.empty()) {
+    NDN_THROW(std::runtime_error("Cannot aggregate an empty set of keys"));
+  }
+  std::vector<BLSPublicKey> pubKeys;
+  pubKeys.reserve(indexes.size());
+  for (auto index : indexes) {
+    pubKeys.push_back(getPublicKey(index));
+  }
+  return ndnBLSAggregatePublicKey(pubKeys);
+}
+
+}  // namespace mps
+}  // namespace ndn
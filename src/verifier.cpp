@@ -1,4 +1,5 @@
 #include "ndnmps/verifier.hpp"
+#include "ndnmps/metrics.hpp"
 
 #include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/util/logger.hpp>
@@ -10,6 +11,26 @@ namespace mps {
 
 NDN_LOG_INIT(ndnmps.blsverifier);
 
+namespace {
+
+struct VerifierMetrics
+{
+  MetricCounter& m_verifications = Metrics::get().counter("verifier.verifications");
+  MetricCounter& m_failures = Metrics::get().counter("verifier.failures");
+  LatencyHistogram& m_schemaCheck = Metrics::get().histogram("verifier.schema_check");
+  LatencyHistogram& m_keyAggregation = Metrics::get().histogram("verifier.key_aggregation");
+  LatencyHistogram& m_pairing = Metrics::get().histogram("verifier.pairing");
+};
+
+VerifierMetrics&
+metrics()
+{
+  static VerifierMetrics metrics;
+  return metrics;
+}
+
+} // namespace
+
 BLSVerifier::BLSVerifier(Face& face)
     : m_face(face)
 {
@@ -17,6 +38,28 @@ BLSVerifier::BLSVerifier(Face& face)
 
 bool
 BLSVerifier::verify(const Data& data, const Data& signatureInfoData)
+{
+  metrics().m_verifications.increment();
+  auto isValid = verifyWithSignerList(data, signatureInfoData);
+  if (!isValid) {
+    metrics().m_failures.increment();
+  }
+  return isValid;
+}
+
+bool
+BLSVerifier::verify(const Data& data)
+{
+  metrics().m_verifications.increment();
+  auto isValid = verifyWithKeyLocator(data);
+  if (!isValid) {
+    metrics().m_failures.increment();
+  }
+  return isValid;
+}
+
+bool
+BLSVerifier::verifyWithSignerList(const Data& data, const Data& signatureInfoData)
 {
   // check key locator matches infoData
   try {
@@ -32,39 +75,147 @@ BLSVerifier::verify(const Data& data, const Data& signatureInfoData)
   }
 
   // check signer list
-  MpsSignerList signerList;
+  MpsSignerListView signerList;
+  MpsSignerList rosterSignerList;
+  std::vector<size_t> rosterIndexes;
+  bool isRosterList = false;
   const auto& signerListBlock = signatureInfoData.getContent();
-  signerListBlock.parse();
-  if (signerListBlock.get(tlv::MpsSignerList).isValid()) {
-    signerList.wireDecode(signerListBlock.get(tlv::MpsSignerList));
+  try {
+    signerListBlock.parse();
+    auto rosterListIt = signerListBlock.find(tlv::MpsRosterSignerList);
+    if (rosterListIt != signerListBlock.elements_end()) {
+      if (m_schemaContainer.m_roster == nullptr) {
+        NDN_LOG_INFO("signer list refers to a roster but no roster is loaded");
+        return false;
+      }
+      isRosterList = true;
+      rosterIndexes = m_schemaContainer.m_roster->decodeSignerIndexes(*rosterListIt);
+      rosterSignerList = m_schemaContainer.m_roster->getSignerList(rosterIndexes);
+    }
+    else {
+      signerList = MpsSignerListView(signerListBlock.get(tlv::MpsSignerList));
+    }
   }
-  auto begin = std::chrono::steady_clock::now();
-  if (!m_schemaContainer.passSchema(data.getName(), signerList)) {
+  catch (const std::exception& e) {
+    NDN_LOG_INFO("cannot decode the signer list: " << e.what());
+    return false;
+  }
+  ScopedTimer schemaTimer(metrics().m_schemaCheck);
+  // the keys of a signer list are looked up once, for both the schema check and the aggregation
+  std::vector<const BLSPublicKey*> signerKeys;
+  auto isPassed = isRosterList ? m_schemaContainer.passSchema(data.getName(), rosterSignerList)
+                               : m_schemaContainer.passSchema(data.getName(), signerList, &signerKeys);
+  schemaTimer.stop();
+  if (!isPassed) {
     NDN_LOG_INFO("signer list cannot pass the schema");
     return false;
   }
-  auto end = std::chrono::steady_clock::now();
-  std::cout << "Verifier verifying signer lists: "
-            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-            << "[µs]" << std::endl;
 
   // verify signature
+  if (isRosterList ? rosterIndexes.empty() : signerList.empty()) {
+    NDN_LOG_INFO("empty signer list");
+    return false;
+  }
   BLSPublicKey aggKey;
-  begin = std::chrono::steady_clock::now();
-  aggKey = m_schemaContainer.aggregateKey(signerList);
-  end = std::chrono::steady_clock::now();
-  std::cout << "Verifier aggregating public keys of size " << signerList.m_signers.size() << ": "
-            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-            << "[µs]" << std::endl;
-  begin = std::chrono::steady_clock::now();
-  auto verifyResult = ndnBLSVerify(aggKey, data);
-  end = std::chrono::steady_clock::now();
-  std::cout << "Verifier verifying BLS signature: "
-            << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()
-            << "[µs]" << std::endl;
+  {
+    ScopedTimer timer(metrics().m_keyAggregation);
+    if (isRosterList) {
+      // the indexes map straight to the keys of the roster
+      aggKey = m_schemaContainer.m_roster->aggregateKey(rosterIndexes);
+    }
+    else {
+      aggKey = getAggregateKey(signerList, signerKeys);
+    }
+  }
+  bool verifyResult;
+  {
+    ScopedTimer timer(metrics().m_pairing);
+    verifyResult = ndnBLSVerify(aggKey, data);
+  }
+  NDN_LOG_DEBUG("Verified " << data.getName() << " signed by " << (isRosterList ? rosterIndexes.size() : signerList.size())
+                << " signers: " << (verifyResult ? "valid" : "invalid"));
   return verifyResult;
 }
 
+bool
+BLSVerifier::verifyWithKeyLocator(const Data& data)
+{
+  Name keyName;
+  try {
+    keyName = data.getSignatureInfo().getKeyLocator().getName();
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_INFO("key locator is not a name or does not exist");
+    return false;
+  }
+  if (!m_schemaContainer.passSchema(data.getName(), MpsSignerList(std::vector<Name>{keyName}))) {
+    NDN_LOG_INFO("signing key cannot pass the schema");
+    return false;
+  }
+  return ndnBLSVerify(m_schemaContainer.getTrustedKey(keyName), data);
+}
+
+bool
+BLSVerifier::verifyBundle(const BLSDataBundle& bundle)
+{
+  const auto& packets = bundle.getPackets();
+  std::vector<BLSPublicKey> pubKeys;
+  pubKeys.reserve(packets.size());
+  try {
+    auto keyNames = bundle.getSignerKeyNames();
+    for (size_t i = 0; i < packets.size(); i++) {
+      if (packets[i].getSignatureType() != tlv::SignatureSha256WithBls) {
+        NDN_LOG_INFO("bundled packet is not signed with BLS: " << packets[i].getName());
+        return false;
+      }
+      if (!m_schemaContainer.passSchema(packets[i].getName(), MpsSignerList(std::vector<Name>{keyNames[i]}))) {
+        NDN_LOG_INFO("signer of bundled packet cannot pass the schema: " << packets[i].getName());
+        return false;
+      }
+      pubKeys.push_back(m_schemaContainer.getTrustedKey(keyNames[i]));
+    }
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_INFO("cannot resolve the signers of the bundle: " << e.what());
+    return false;
+  }
+  return ndnBLSAggregateVerify(pubKeys, packets, bundle.getAggregateSignature());
+}
+
+BLSPublicKey
+BLSVerifier::getAggregateKey(const MpsSignerListView& signers, const std::vector<const BLSPublicKey*>& pubKeys)
+{
+  // the entries are compared by the signer set hash first, so a miss costs one comparison per entry
+  for (auto it = m_signerListCache.begin(); it != m_signerListCache.end(); it++) {
+    if (it->m_signers == signers) {
+      // a trusted key may have been replaced since the entry was made, which makes the entry stale
+      bool isStale = it->m_keys.size() != pubKeys.size();
+      for (size_t i = 0; !isStale && i < pubKeys.size(); i++) {
+        isStale = !blsPublicKeyIsEqual(&it->m_keys[i], pubKeys[i]);
+      }
+      if (isStale) {
+        m_signerListCache.erase(it);
+        break;
+      }
+      m_signerListCache.splice(m_signerListCache.begin(), m_signerListCache, it);
+      return m_signerListCache.front().m_aggregateKey;
+    }
+  }
+  std::vector<BLSPublicKey> keys;
+  keys.reserve(pubKeys.size());
+  for (auto pubKey : pubKeys) {
+    keys.push_back(*pubKey);
+  }
+  auto aggKey = ndnBLSAggregatePublicKey(keys);
+  if (m_signerListCacheLimit > 0) {
+    m_signerListCache.push_front(SignerListCacheEntry{signers, std::move(keys), aggKey});
+    while (m_signerListCache.size() > m_signerListCacheLimit) {
+      m_signerListCache.pop_back();
+    }
+  }
+  return aggKey;
+}
+
 void
 BLSVerifier::asyncVerify(const Data& data, const VerifyFinishCallback& callback)
 {
@@ -76,6 +227,11 @@ BLSVerifier::asyncVerify(const Data& data, const VerifyFinishCallback& callback)
     callback(false);
     return;
   }
+  if (m_schemaContainer.isTrustedKey(keyLocatorName)) {
+    // signed by a single trusted key, e.g. a threshold group key, so there is no signature info Data
+    callback(verify(data));
+    return;
+  }
 
   Interest interest(keyLocatorName);
   interest.setCanBePrefix(true);
@@ -1,4 +1,5 @@
 #include "ndnmps/bls-helpers.hpp"
+#include "ndnmps/metrics.hpp"
 #include "test-common.hpp"
 #include <iostream>
 
@@ -80,6 +81,197 @@ BOOST_AUTO_TEST_CASE(TestSignAndAggregateVerify)
   BOOST_CHECK(ndnBLSVerify(aggKey, interest));
 }
 
+BOOST_AUTO_TEST_CASE(TestBatchVerify)
+{
+  ndnBLSInit();
+
+  std::vector<BLSPublicKey> pks;
+  std::vector<BLSSignature> sigs;
+  std::vector<Buffer> messages;
+  for (int i = 0; i < 8; i++) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    std::string message = "message " + std::to_string(i);
+    BLSSignature sig;
+    blsSign(&sig, &sk, message.data(), message.size());
+    pks.push_back(pk);
+    sigs.push_back(sig);
+    messages.emplace_back(message.data(), message.size());
+  }
+  BOOST_CHECK(ndnBLSBatchVerify(pks, sigs, messages));
+  BOOST_CHECK(ndnBLSFindInvalidSignatures(pks, sigs, messages).empty());
+
+  // swapped signatures are valid signatures, but not for these messages
+  std::swap(sigs[2], sigs[5]);
+  BOOST_CHECK(!ndnBLSBatchVerify(pks, sigs, messages));
+  auto invalidIndexes = ndnBLSFindInvalidSignatures(pks, sigs, messages);
+  BOOST_CHECK_EQUAL(invalidIndexes.size(), 2);
+  BOOST_CHECK(invalidIndexes == std::vector<size_t>({2, 5}));
+
+  BOOST_CHECK(ndnBLSBatchVerify({}, {}, {}));
+  BOOST_CHECK_THROW(ndnBLSBatchVerify(pks, sigs, {}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TestBatchVerifySameMessage)
+{
+  ndnBLSInit();
+
+  std::string message = "same message";
+  Buffer messageBuf(message.data(), message.size());
+  std::vector<BLSPublicKey> pks;
+  std::vector<BLSSignature> sigs;
+  for (int i = 0; i < 8; i++) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    BLSSignature sig;
+    blsSign(&sig, &sk, message.data(), message.size());
+    pks.push_back(pk);
+    sigs.push_back(sig);
+  }
+  BOOST_CHECK(ndnBLSBatchVerifySameMessage(pks, sigs, messageBuf));
+  BOOST_CHECK(ndnBLSFindInvalidSignaturesSameMessage(pks, sigs, messageBuf).empty());
+
+  // a piece over another message
+  std::string otherMessage = "other message";
+  BLSSecretKey sk;
+  blsSecretKeySetByCSPRNG(&sk);
+  blsGetPublicKey(&pks[6], &sk);
+  blsSign(&sigs[6], &sk, otherMessage.data(), otherMessage.size());
+  // swapped pieces still add up to the right aggregate, but are invalid one by one
+  std::swap(sigs[1], sigs[3]);
+  BOOST_CHECK(!ndnBLSBatchVerifySameMessage(pks, sigs, messageBuf));
+  auto invalidIndexes = ndnBLSFindInvalidSignaturesSameMessage(pks, sigs, messageBuf);
+  BOOST_CHECK(invalidIndexes == std::vector<size_t>({1, 3, 6}));
+
+  BOOST_CHECK(ndnBLSFindInvalidSignaturesSameMessage({}, {}, messageBuf).empty());
+  BOOST_CHECK_THROW(ndnBLSBatchVerifySameMessage(pks, {}, messageBuf), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TestAggregateVerify)
+{
+  ndnBLSInit();
+
+  std::vector<BLSPublicKey> pks;
+  std::vector<Buffer> messages;
+  std::vector<BLSSignature> sigs;
+  for (int i = 0; i < 4; i++) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    std::string message = "message " + std::to_string(i);
+    BLSSignature sig;
+    blsSign(&sig, &sk, message.data(), message.size());
+    pks.push_back(pk);
+    messages.emplace_back(message.data(), message.size());
+    sigs.push_back(sig);
+  }
+  auto aggSig = ndnBLSAggregateSignature(sigs);
+  BOOST_CHECK(ndnBLSAggregateVerify(pks, messages, aggSig));
+
+  // the aggregate does not cover another message
+  auto otherMessages = messages;
+  otherMessages[3][0] ^= 0x01;
+  BOOST_CHECK(!ndnBLSAggregateVerify(pks, otherMessages, aggSig));
+
+  // repeated messages are rejected even if the aggregate is valid
+  BLSSecretKey sk;
+  blsSecretKeySetByCSPRNG(&sk);
+  BLSPublicKey pk;
+  blsGetPublicKey(&pk, &sk);
+  BLSSignature sig;
+  blsSign(&sig, &sk, messages[0].data(), messages[0].size());
+  pks.push_back(pk);
+  messages.push_back(messages[0]);
+  blsSignatureAdd(&aggSig, &sig);
+  BOOST_CHECK(!ndnBLSAggregateVerify(pks, messages, aggSig));
+
+  BOOST_CHECK(!ndnBLSAggregateVerify({}, std::vector<Buffer>{}, aggSig));
+  BOOST_CHECK_THROW(ndnBLSAggregateVerify(pks, std::vector<Buffer>{}, aggSig), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TestThresholdSignature)
+{
+  ndnBLSInit();
+
+  BLSPublicKey groupKey;
+  std::vector<BLSSecretKey> shares;
+  std::tie(groupKey, shares) = ndnBLSDealKeyShares(3, 5);
+  BOOST_CHECK_EQUAL(shares.size(), 5);
+
+  std::string message = "message";
+  std::vector<BLSSignature> pieces(5);
+  for (size_t i = 0; i < 5; i++) {
+    blsSign(&pieces[i], &shares[i], message.data(), message.size());
+  }
+  // any 3 pieces give the same signature of the group key
+  auto sig1 = ndnBLSRecoverSignature({pieces[0], pieces[1], pieces[2]}, {1, 2, 3});
+  auto sig2 = ndnBLSRecoverSignature({pieces[4], pieces[1], pieces[3]}, {5, 2, 4});
+  BOOST_CHECK(blsSignatureIsEqual(&sig1, &sig2));
+  BOOST_CHECK(blsVerify(&sig1, &groupKey, message.data(), message.size()) == 1);
+
+  // 2 pieces are not enough
+  auto sig3 = ndnBLSRecoverSignature({pieces[0], pieces[1]}, {1, 2});
+  BOOST_CHECK(blsVerify(&sig3, &groupKey, message.data(), message.size()) == 0);
+
+  BOOST_CHECK_THROW(ndnBLSRecoverSignature({pieces[0], pieces[1]}, {1, 1}), std::runtime_error);
+  BOOST_CHECK_THROW(ndnBLSRecoverSignature({pieces[0]}, {0}), std::runtime_error);
+  BOOST_CHECK_THROW(ndnBLSDealKeyShares(4, 3), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TestSignatureCache)
+{
+  ndnBLSInit();
+
+  std::vector<BLSSecretKey> sks(2);
+  std::vector<BLSPublicKey> pks(2);
+  for (size_t i = 0; i < 2; i++) {
+    blsSecretKeySetByCSPRNG(&sks[i]);
+    blsGetPublicKey(&pks[i], &sks[i]);
+  }
+  Data data;
+  data.setName(Name("/a/b/c/d"));
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls),
+                     KeyLocator(Name("/signer/KEY/123")));
+  auto uncached = ndnGenBLSSignature(sks[0], data, info);
+
+  ndnBLSSetSignatureCacheCapacity(2);
+  Metrics::get().reset();
+  Metrics::setEnabled(true);
+  auto& counters = Metrics::get();
+  // the first signature fills both caches, another key reuses the hash, and the same key the signature
+  BOOST_CHECK(ndnGenBLSSignature(sks[0], data, info) == uncached);
+  BOOST_CHECK(ndnGenBLSSignature(sks[1], data, info) != uncached);
+  BOOST_CHECK(ndnGenBLSSignature(sks[0], data, info) == uncached);
+  BOOST_CHECK_EQUAL(counters.counter("bls.signature_cache_misses").get(), 1);
+  BOOST_CHECK_EQUAL(counters.counter("bls.hash_cache_hits").get(), 1);
+  BOOST_CHECK_EQUAL(counters.counter("bls.signature_cache_hits").get(), 1);
+
+  // cached signatures verify, also for Interests
+  auto signedData = data;
+  ndnBLSSign(sks[1], signedData, info);
+  BOOST_CHECK(ndnBLSVerify(pks[1], signedData));
+  Interest interest(Name("/a/b/c/d"));
+  interest.setApplicationParameters(Name("/1/2/3/4").wireEncode());
+  ndnBLSSign(sks[0], interest, info);
+  auto retried = interest;
+  ndnBLSSign(sks[0], retried, info);
+  BOOST_CHECK(ndnBLSVerify(pks[0], retried));
+  BOOST_CHECK(retried.getSignatureValue() == interest.getSignatureValue());
+  BOOST_CHECK_EQUAL(counters.counter("bls.signature_cache_hits").get(), 3);
+
+  // a disabled cache is cleared
+  ndnBLSSetSignatureCacheCapacity(0);
+  BOOST_CHECK(ndnGenBLSSignature(sks[0], data, info) == uncached);
+  BOOST_CHECK_EQUAL(counters.counter("bls.signature_cache_hits").get(), 3);
+  Metrics::setEnabled(false);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestBLSHelper
 
 }  // namespace tests
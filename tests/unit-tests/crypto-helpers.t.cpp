@@ -0,0 +1,165 @@
+#include "ndnmps/crypto-helpers.hpp"
+#include "test-common.hpp"
+#include <ndn-cxx/util/random.hpp>
+#include <ndn-cxx/util/string-helper.hpp>
+#include <chrono>
+#include <thread>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestCryptoHelpers)
+
+BOOST_AUTO_TEST_CASE(EcdhKeyPool)
+{
+  ECDHKeyPool pool(8, 2);
+  for (int i = 0; i < 100 && pool.size() < 8; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_CHECK_EQUAL(pool.size(), 8);
+
+  // keys from the pool and freshly generated keys derive the same secret
+  ECDHState pooled(&pool);
+  ECDHState generated;
+  auto pooledSecret = pooled.deriveSecret(generated.getSelfPubKey());
+  auto generatedSecret = generated.deriveSecret(pooled.getSelfPubKey());
+  BOOST_CHECK(pooledSecret == generatedSecret);
+  BOOST_CHECK(pooled.getSelfPubKey() != generated.getSelfPubKey());
+
+  // an empty pool still hands out keys
+  std::vector<std::unique_ptr<ECDHState>> states;
+  for (int i = 0; i < 20; i++) {
+    states.push_back(make_unique<ECDHState>(&pool));
+  }
+  BOOST_CHECK(states.front()->getSelfPubKey() != states.back()->getSelfPubKey());
+}
+
+BOOST_AUTO_TEST_CASE(AesGcmInPlace)
+{
+  std::array<uint8_t, 16> key;
+  random::generateSecureBytes(key.data(), key.size());
+  AesGcm128Session session;
+  session.setKey(key.data());
+  Buffer payload(3000);
+  random::generateSecureBytes(payload.data(), payload.size());
+
+  EncodingBuffer encoder(payload.size() + 64, 0);
+  auto length = prependBlockWithAesGcm128(encoder, ndn::tlv::Content, session, payload.data(), payload.size(),
+                                          nullptr, 0);
+  auto block = encoder.block();
+  BOOST_CHECK_EQUAL(length, block.size());
+  // same layout as the Block-based encoding
+  BOOST_CHECK(decodeBlockWithAesGcm128(block, key.data(), nullptr, 0) == payload);
+
+  auto wire = encodeBlockWithAesGcm128(ndn::tlv::Content, session, payload.data(), payload.size(), nullptr, 0);
+  Buffer buffer(wire.begin(), wire.end());
+  size_t offset = 0;
+  size_t size = 0;
+  std::tie(offset, size) = decryptBlockWithAesGcm128InPlace(buffer.data(), buffer.size(), session, nullptr, 0);
+  BOOST_CHECK_EQUAL_COLLECTIONS(buffer.begin() + offset, buffer.begin() + offset + size,
+                                payload.begin(), payload.end());
+
+  // tampered ciphertext
+  Buffer tampered(wire.begin(), wire.end());
+  tampered[tampered.size() - 1] ^= 0x01;
+  BOOST_CHECK_THROW(decryptBlockWithAesGcm128InPlace(tampered.data(), tampered.size(), session, nullptr, 0),
+                    std::runtime_error);
+  // truncated block
+  BOOST_CHECK_THROW(decryptBlockWithAesGcm128InPlace(tampered.data(), 20, session, nullptr, 0),
+                    std::runtime_error);
+}
+
+BOOST_FIXTURE_TEST_CASE(HmacDataSignature, IdentityManagementFixture)
+{
+  std::array<uint8_t, 32> key;
+  random::generateSecureBytes(key.data(), key.size());
+  Data data(Name("/a/b/c"));
+  data.setContent(Name("/1/2/3").wireEncode());
+  signDataWithHmacSha256(data, key.data(), key.size());
+  BOOST_CHECK_EQUAL(data.getSignatureType(), ndn::tlv::SignatureHmacWithSha256);
+  BOOST_CHECK(verifyDataWithHmacSha256(Data(data.wireEncode()), key.data(), key.size()));
+
+  // wrong key
+  auto wrongKey = key;
+  wrongKey[0] ^= 0x01;
+  BOOST_CHECK(!verifyDataWithHmacSha256(data, wrongKey.data(), wrongKey.size()));
+  // tampered packet
+  Data tampered(data.wireEncode());
+  tampered.setContent(Name("/1/2/4").wireEncode());
+  BOOST_CHECK(!verifyDataWithHmacSha256(tampered, key.data(), key.size()));
+
+  // signatures from KeyChain verify with the raw key and vice versa, though the KeyChain one carries a KeyLocator
+  security::SigningInfo signingInfo;
+  signingInfo.setSigningHmacKey(base64EncodeFromBytes(key.data(), key.size(), false));
+  signingInfo.setDigestAlgorithm(DigestAlgorithm::SHA256);
+  Data signedByKeyChain(Name("/a/b/c"));
+  signedByKeyChain.setContent(Name("/1/2/3").wireEncode());
+  m_keyChain.sign(signedByKeyChain, signingInfo);
+  BOOST_CHECK(verifyDataWithHmacSha256(signedByKeyChain, key.data(), key.size()));
+  BOOST_CHECK(security::verifySignature(data, m_keyChain.getTpm(), signingInfo.getSignerName(),
+                                        DigestAlgorithm::SHA256));
+}
+
+BOOST_AUTO_TEST_CASE(HkdfKnownAnswers)
+{
+  auto byteRange = [](uint8_t first, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) {
+      bytes[i] = static_cast<uint8_t>(first + i);
+    }
+    return bytes;
+  };
+  auto checkHkdf = [](const std::vector<uint8_t>& ikm, const std::vector<uint8_t>& salt,
+                      const std::vector<uint8_t>& info, const std::string& okmHex) {
+    auto expected = fromHex(okmHex);
+    std::vector<uint8_t> okm(expected->size());
+    BOOST_CHECK_EQUAL(hkdf(ikm.data(), ikm.size(), salt.data(), salt.size(), okm.data(), okm.size(),
+                           info.data(), info.size()),
+                      okm.size());
+    BOOST_CHECK_EQUAL_COLLECTIONS(okm.begin(), okm.end(), expected->begin(), expected->end());
+  };
+
+  // RFC 5869 A.1: basic test case with SHA-256
+  checkHkdf(std::vector<uint8_t>(22, 0x0b), byteRange(0x00, 13), byteRange(0xf0, 10),
+            "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865");
+  // RFC 5869 A.2: longer inputs and outputs
+  checkHkdf(byteRange(0x00, 80), byteRange(0x60, 80), byteRange(0xb0, 80),
+            "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c"
+            "59045a99cac7827271cb41c65e590e09da3275600c2f09b8367793a9aca3db71"
+            "cc30c58179ec3e87c14c01d5c1f3434f1d87");
+  // RFC 5869 A.3: zero-length salt and info
+  checkHkdf(std::vector<uint8_t>(22, 0x0b), {}, {},
+            "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8");
+
+  // the output is limited to 255 blocks
+  std::vector<uint8_t> tooLong(255 * 32 + 1);
+  auto ikm = byteRange(0x00, 32);
+  BOOST_CHECK_THROW(hkdf(ikm.data(), ikm.size(), nullptr, 0, tooLong.data(), tooLong.size()),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ResumedKeys)
+{
+  std::vector<uint8_t> secret(32);
+  for (size_t i = 0; i < secret.size(); i++) {
+    secret[i] = static_cast<uint8_t>(i);
+  }
+  // HKDF-SHA256 with salt = counter | ticket ID and info = "ndnmps resumption"
+  auto expected = fromHex("d21609700af54019ac0d86140d70fc268222f0896d8a27b1bfafdb157abf409a"
+                          "6eb82177a74f13d4ad42d7470163f6d1");
+  std::array<uint8_t, 48> keys;
+  deriveResumedKeys(secret.data(), secret.size(), 0x0102030405060708, 7, keys.data(), keys.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(keys.begin(), keys.end(), expected->begin(), expected->end());
+
+  // every request gets fresh keys
+  std::array<uint8_t, 48> nextKeys;
+  deriveResumedKeys(secret.data(), secret.size(), 0x0102030405060708, 8, nextKeys.data(), nextKeys.size());
+  BOOST_CHECK(keys != nextKeys);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCryptoHelpers
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
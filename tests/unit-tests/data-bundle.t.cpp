@@ -0,0 +1,68 @@
+#include "ndnmps/data-bundle.hpp"
+#include "ndnmps/verifier.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestDataBundle, IdentityManagementTimeFixture)
+
+BOOST_AUTO_TEST_CASE(SegmentSeries)
+{
+  ndnBLSInit();
+
+  BLSSecretKey skA, skB;
+  BLSPublicKey pkA, pkB;
+  blsSecretKeySetByCSPRNG(&skA);
+  blsSecretKeySetByCSPRNG(&skB);
+  blsGetPublicKey(&pkA, &skA);
+  blsGetPublicKey(&pkB, &skB);
+
+  BLSDataBundle bundle;
+  for (int i = 0; i < 16; i++) {
+    Data segment(Name("/dataset/object").appendSegment(i));
+    segment.setContent(Name("/segment/" + std::to_string(i)).wireEncode());
+    if (i % 2 == 0) {
+      bundle.addPacket(segment, skA, Name("/a/KEY/1"));
+    }
+    else {
+      bundle.addPacket(segment, skB, Name("/b/KEY/1"));
+    }
+  }
+  BOOST_CHECK_EQUAL(bundle.getPackets().size(), 16);
+  BOOST_CHECK_EQUAL(bundle.getPackets()[0].getSignatureValue().value_size(), 0);
+  BOOST_CHECK_EQUAL(bundle.getSignerKeyNames()[1], Name("/b/KEY/1"));
+
+  BLSDataBundle decoded(bundle.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getPackets().size(), 16);
+  BOOST_CHECK(blsSignatureIsEqual(&decoded.getAggregateSignature(), &bundle.getAggregateSignature()));
+  BOOST_CHECK_THROW(BLSDataBundle(Name("/a").wireEncode()), ndn::tlv::Error);
+
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/dataset/object/*");
+  schema.m_ruleId = "01";
+  schema.m_optionalSigners.emplace_back(Name("/a/KEY/1"));
+  schema.m_optionalSigners.emplace_back(Name("/b/KEY/1"));
+  schema.m_minOptionalSigners = 1;
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/a/KEY/1"), pkA);
+  // unknown signer
+  BOOST_CHECK(!verifier.verifyBundle(decoded));
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/b/KEY/1"), pkB);
+  BOOST_CHECK(verifier.verifyBundle(decoded));
+
+  // a packet signed by another key than the one in its KeyLocator
+  BLSDataBundle forged;
+  Data segment(Name("/dataset/object").appendSegment(0));
+  forged.addPacket(segment, skA, Name("/b/KEY/1"));
+  BOOST_CHECK(!verifier.verifyBundle(forged));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDataBundle
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
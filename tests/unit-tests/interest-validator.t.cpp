@@ -0,0 +1,134 @@
+#include "ndnmps/interest-validator.hpp"
+#include "test-common.hpp"
+#include <ndn-cxx/util/random.hpp>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_FIXTURE_TEST_SUITE(TestInterestValidator, IdentityManagementTimeFixture)
+
+/**
+ * A command Interest signed by the key, with the current time and a random nonce unless given.
+ */
+static Interest
+makeCommand(const Name& name, const BLSSecretKey& sk, const Name& keyName,
+            optional<std::vector<uint8_t>> nonce = nullopt)
+{
+  Interest interest(name);
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls), KeyLocator(keyName));
+  info.setTime();
+  if (!nonce) {
+    nonce = std::vector<uint8_t>(8);
+    random::generateSecureBytes(nonce->data(), nonce->size());
+  }
+  info.setNonce(nonce);
+  ndnBLSSign(sk, interest, info);
+  return interest;
+}
+
+BOOST_AUTO_TEST_CASE(ReplayWindow)
+{
+  ndnBLSInit();
+  BLSSecretKey sk;
+  BLSPublicKey pk;
+  blsSecretKeySetByCSPRNG(&sk);
+  blsGetPublicKey(&pk, &sk);
+  MultipartySchemaContainer container;
+  container.m_trustedIds.emplace(Name("/a/KEY/1"), pk);
+  BLSInterestValidator validator(container);
+
+  auto command = makeCommand("/ctrl/start", sk, "/a/KEY/1");
+  BOOST_CHECK(validator.validate(command));
+  // the same Interest again
+  BOOST_CHECK(!validator.validate(command));
+  // an untrusted key
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK(!validator.validate(makeCommand("/ctrl/start", sk, "/b/KEY/1")));
+  // a reused nonce with a new timestamp
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK(!validator.validate(makeCommand("/ctrl/start", sk, "/a/KEY/1", *command.getSignatureInfo()->getNonce())));
+  // a timestamp out of the grace period
+  auto stale = makeCommand("/ctrl/stop", sk, "/a/KEY/1");
+  advanceClocks(time::seconds(61));
+  BOOST_CHECK(!validator.validate(stale));
+  // an unsigned or tampered Interest
+  BOOST_CHECK(!validator.validate(Interest(Name("/ctrl/stop"))));
+  auto tampered = makeCommand("/ctrl/stop", sk, "/a/KEY/1");
+  tampered.setApplicationParameters(Name("/other").wireEncode());
+  BOOST_CHECK(!validator.validate(tampered));
+  // a fresh Interest is still accepted
+  BOOST_CHECK(validator.validate(makeCommand("/ctrl/stop", sk, "/a/KEY/1")));
+
+  // nonces are only remembered by valid Interests, and one per key
+  validator.clear();
+  validator.m_shouldValidateTimestamps = false;
+  validator.m_maxNoncesPerKey = 1;
+  auto first = makeCommand("/ctrl/1", sk, "/a/KEY/1");
+  BOOST_CHECK(validator.validate(first));
+  BOOST_CHECK(validator.validate(makeCommand("/ctrl/2", sk, "/a/KEY/1")));
+  BOOST_CHECK(validator.validate(first));
+
+  // the Interests of a key whose record is dropped cannot be replayed
+  validator.clear();
+  validator.m_shouldValidateTimestamps = true;
+  validator.m_maxNoncesPerKey = 1000;
+  validator.m_maxRecords = 1;
+  container.m_trustedIds.emplace(Name("/b/KEY/1"), pk);
+  auto fromA = makeCommand("/ctrl/a", sk, "/a/KEY/1");
+  BOOST_CHECK(validator.validate(fromA));
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK(validator.validate(makeCommand("/ctrl/b", sk, "/b/KEY/1")));
+  BOOST_CHECK(!validator.validate(fromA));
+  advanceClocks(time::milliseconds(10));
+  BOOST_CHECK(validator.validate(makeCommand("/ctrl/a", sk, "/a/KEY/1")));
+
+  // but Interests signed before a record of another key is dropped are still accepted
+  for (int i = 0; i < 3; i++) {
+    advanceClocks(time::milliseconds(10));
+    auto delayedA = makeCommand("/ctrl/a", sk, "/a/KEY/1");
+    auto delayedB = makeCommand("/ctrl/b", sk, "/b/KEY/1");
+    advanceClocks(time::milliseconds(5));
+    BOOST_CHECK(validator.validate(delayedB));
+    BOOST_CHECK(validator.validate(delayedA));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Burst)
+{
+  ndnBLSInit();
+  MultipartySchemaContainer container;
+  std::vector<BLSSecretKey> sks(4);
+  for (size_t i = 0; i < sks.size(); i++) {
+    BLSPublicKey pk;
+    blsSecretKeySetByCSPRNG(&sks[i]);
+    blsGetPublicKey(&pk, &sks[i]);
+    container.m_trustedIds.emplace(Name("/k" + std::to_string(i) + "/KEY/1"), pk);
+  }
+  BLSInterestValidator validator(container);
+
+  std::vector<Interest> burst;
+  for (size_t i = 0; i < 16; i++) {
+    auto keyIndex = i % sks.size();
+    burst.push_back(makeCommand(Name("/ctrl").appendNumber(i), sks[keyIndex],
+                                "/k" + std::to_string(keyIndex) + "/KEY/1"));
+    advanceClocks(time::milliseconds(1));
+  }
+  // a forged signature, and a replay within the burst
+  burst[5] = makeCommand("/ctrl/5", sks[0], "/k1/KEY/1");
+  burst.push_back(burst[2]);
+
+  auto results = validator.validate(burst);
+  BOOST_REQUIRE_EQUAL(results.size(), 17);
+  for (size_t i = 0; i < results.size(); i++) {
+    BOOST_CHECK_EQUAL(static_cast<bool>(results[i]), i != 5 && i != 16);
+  }
+  // the burst has been recorded
+  BOOST_CHECK(!validator.validate(burst[0]));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestInterestValidator
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
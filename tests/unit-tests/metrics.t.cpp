@@ -0,0 +1,86 @@
+#include "ndnmps/metrics.hpp"
+#include "test-common.hpp"
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestMetrics)
+
+BOOST_AUTO_TEST_CASE(HistogramBuckets)
+{
+  for (uint64_t value : std::vector<uint64_t>{0, 1, 15, 16, 17, 31, 32, 1000, 123456789, 1ULL << 40}) {
+    auto index = LatencyHistogram::getBucketIndex(value);
+    BOOST_CHECK_LT(index, LatencyHistogram::BUCKET_COUNT);
+    auto upperBound = LatencyHistogram::getBucketUpperBound(index);
+    BOOST_CHECK_GE(upperBound, value);
+    // the relative error is bounded by the sub-buckets
+    BOOST_CHECK_LE(upperBound - value, value / LatencyHistogram::SUB_BUCKET_COUNT);
+    if (index > 0) {
+      BOOST_CHECK_LT(LatencyHistogram::getBucketUpperBound(index - 1), value);
+    }
+  }
+  BOOST_CHECK_EQUAL(LatencyHistogram::getBucketIndex(std::numeric_limits<uint64_t>::max()),
+                    LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramPercentiles)
+{
+  Metrics::setEnabled(true);
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 1000; value++) {
+    histogram.record(value * 1000);
+  }
+  auto snapshot = histogram.snapshot();
+  BOOST_CHECK_EQUAL(snapshot.m_count, 1000);
+  BOOST_CHECK_EQUAL(snapshot.m_min, 1000);
+  BOOST_CHECK_EQUAL(snapshot.m_max, 1000000);
+  BOOST_CHECK_EQUAL(snapshot.m_sum, 500500000);
+  auto p50 = snapshot.getPercentile(50);
+  BOOST_CHECK_GE(p50, 500000);
+  BOOST_CHECK_LE(p50, 500000 + 500000 / 16);
+  BOOST_CHECK_EQUAL(snapshot.getPercentile(100), 1000000);
+
+  histogram.reset();
+  BOOST_CHECK_EQUAL(histogram.snapshot().m_count, 0);
+  BOOST_CHECK_EQUAL(histogram.snapshot().getPercentile(99), 0);
+  Metrics::setEnabled(false);
+}
+
+BOOST_AUTO_TEST_CASE(Registry)
+{
+  auto& counter = Metrics::get().counter("test.counter");
+  auto& histogram = Metrics::get().histogram("test.histogram");
+  BOOST_CHECK_EQUAL(&counter, &Metrics::get().counter("test.counter"));
+  Metrics::get().reset();
+
+  // disabled metrics drop updates
+  counter.increment();
+  {
+    ScopedTimer timer(histogram);
+  }
+  BOOST_CHECK_EQUAL(counter.get(), 0);
+  BOOST_CHECK_EQUAL(histogram.snapshot().m_count, 0);
+
+  Metrics::setEnabled(true);
+  counter.increment(2);
+  {
+    ScopedTimer timer(histogram);
+    timer.stop();
+  }
+  histogram.recordSince(std::chrono::steady_clock::time_point());
+  Metrics::setEnabled(false);
+  BOOST_CHECK_EQUAL(Metrics::get().snapshotCounters().at("test.counter"), 2);
+  BOOST_CHECK_EQUAL(Metrics::get().snapshotHistograms().at("test.histogram").m_count, 1);
+
+  auto json = Metrics::get().toJson();
+  BOOST_CHECK(json.find("\"test.counter\": 2") != std::string::npos);
+  BOOST_CHECK(json.find("\"test.histogram\": {\"count\": 1") != std::string::npos);
+  Metrics::get().reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMetrics
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
@@ -86,6 +86,48 @@ BOOST_AUTO_TEST_CASE(Equality)
   BOOST_CHECK_EQUAL(a != b, false);
 }
 
+BOOST_AUTO_TEST_CASE(View)
+{
+  MpsSignerList a(std::vector<Name>{"/A/KEY/1", "/B/KEY/1", "/C/KEY/1"});
+  MpsSignerList b(std::vector<Name>{"/C/KEY/1", "/A/KEY/1", "/B/KEY/1"});
+  MpsSignerList c(std::vector<Name>{"/A/KEY/1", "/B/KEY/1", "/D/KEY/1"});
+
+  MpsSignerListView viewA(a.wireEncode());
+  MpsSignerListView viewB(b.wireEncode());
+  MpsSignerListView viewC(c.wireEncode());
+  BOOST_CHECK_EQUAL(viewA.size(), 3);
+  BOOST_CHECK_EQUAL(std::distance(viewA.begin(), viewA.end()), 3);
+  BOOST_CHECK_EQUAL(Name(*viewB.begin()), Name("/C/KEY/1"));
+
+  // the order of the names does not matter
+  BOOST_CHECK_EQUAL(viewA.getHash(), viewB.getHash());
+  BOOST_CHECK(viewA == viewB);
+  BOOST_CHECK(viewA != viewC);
+  BOOST_CHECK(viewA.toSignerList() == b);
+
+  BOOST_CHECK(MpsSignerListView(MpsSignerList().wireEncode()).empty());
+  BOOST_CHECK_THROW(MpsSignerListView(Name("/A").wireEncode()), ndn::tlv::Error);
+  BOOST_CHECK_THROW(MpsSignerListView(makeNestedBlock(tlv::MpsSignerList, makeStringBlock(ndn::tlv::Content, "A"))),
+                    ndn::tlv::Error);
+
+  WildCardName pattern("/A/*/1");
+  BOOST_CHECK(pattern.match(Name("/A/KEY/1").wireEncode()));
+  BOOST_CHECK(!pattern.match(Name("/A/KEY/2").wireEncode()));
+  BOOST_CHECK(!pattern.match(Name("/A/KEY/1/2").wireEncode()));
+  BOOST_CHECK(!pattern.match(Name("/A/KEY").wireEncode()));
+
+  // names are compared with the encoded elements in the canonical order
+  std::vector<Name> names{"/A", "/A/KEY", "/A/KEY/1", "/A/KEY/2", "/A/KEY/10", "/B", "/AA"};
+  names.push_back(Name("/A").appendVersion(1));
+  for (const auto& lhs : names) {
+    for (const auto& rhs : names) {
+      auto result = compareName(lhs, rhs.wireEncode());
+      BOOST_CHECK_EQUAL(result < 0, lhs < rhs);
+      BOOST_CHECK_EQUAL(result == 0, lhs == rhs);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // TestMpsSignerList
 
 }  // namespace tests
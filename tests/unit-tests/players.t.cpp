@@ -1,8 +1,12 @@
 #include <ndn-cxx/util/dummy-client-face.hpp>
+#include <algorithm>
+#include <set>
 
 #include "ndnmps/signer.hpp"
 #include "ndnmps/verifier.hpp"
 #include "ndnmps/initiator.hpp"
+#include "ndnmps/metrics.hpp"
+#include "ndnmps/tracer.hpp"
 #include "test-common.hpp"
 #include "identity-management-fixture.hpp"
 
@@ -61,6 +65,16 @@ BOOST_AUTO_TEST_CASE(SingleSigner)
   verifier.m_schemaContainer.m_schemas.push_back(schema);
   verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
   BOOST_CHECK(verifier.verify(signedData, infoData));
+
+  // every rejected packet counts as a failure, whatever the stage rejecting it
+  Metrics::get().reset();
+  Metrics::setEnabled(true);
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+  BOOST_CHECK(!verifier.verify(signedData, signedData)); // key locator mismatch
+  BOOST_CHECK(!verifier.verify(signedData)); // the KeyLocator is not a trusted key
+  Metrics::setEnabled(false);
+  BOOST_CHECK_EQUAL(Metrics::get().counter("verifier.verifications").get(), 3);
+  BOOST_CHECK_EQUAL(Metrics::get().counter("verifier.failures").get(), 2);
 }
 
 BOOST_AUTO_TEST_CASE(MultipleSigner)
@@ -125,6 +139,225 @@ BOOST_AUTO_TEST_CASE(MultipleSigner)
     verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
   }
   BOOST_CHECK(verifier.verify(signedData, infoData));
+
+  // replacing a trusted key changes the result, though the aggregated key of the signer list is cached
+  BLSSecretKey otherSecretKey;
+  blsSecretKeySetByCSPRNG(&otherSecretKey);
+  BLSPublicKey otherPublicKey;
+  blsGetPublicKey(&otherPublicKey, &otherSecretKey);
+  verifier.m_schemaContainer.m_trustedIds[signers[0]->getPublicKeyName()] = otherPublicKey;
+  BOOST_CHECK(!verifier.verify(signedData, infoData));
+  verifier.m_schemaContainer.m_trustedIds[signers[0]->getPublicKeyName()] = signers[0]->getPublicKey();
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+}
+
+BOOST_AUTO_TEST_CASE(EncryptPayloadOnce)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // signers
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  for (size_t i = 0; i < 3; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_encryptPayloadOnce = true;
+  for (size_t i = 0; i < 3; i++) {
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  // schema
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  for (size_t i = 0; i < 3; i++) {
+    schema.m_signers.emplace_back(signers[i]->getPublicKeyName());
+  }
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  // start protocol
+  bool callbackInvoked = false;
+  Data signedData, infoData;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                          [&](const auto& d1, const auto& d2) {
+                            callbackInvoked = true;
+                            signedData = d1;
+                            infoData = d2;
+                          },
+                          [](const auto& reason) {
+                            std::cout << reason << std::endl;
+                            BOOST_CHECK(false);
+                          });
+  advanceClocks(time::milliseconds(200), 10);
+  BOOST_CHECK(callbackInvoked);
+
+  // the payload is encrypted once for all signers, and only its key is wrapped for each signer
+  std::vector<Data> payloads;
+  std::map<Name, std::vector<uint8_t>> wrappedKeys; // parameter Data name, encrypted PayloadKey
+  for (const auto& data : face.sentData) {
+    if (Name("/initiator/mps/payload").isPrefixOf(data.getName())) {
+      payloads.push_back(data);
+    }
+    else if (Name("/initiator/mps/param").isPrefixOf(data.getName())) {
+      const auto& content = data.getContent();
+      wrappedKeys.emplace(data.getName(), std::vector<uint8_t>(content.begin(), content.end()));
+    }
+  }
+  BOOST_REQUIRE(!payloads.empty());
+  for (const auto& payload : payloads) {
+    BOOST_CHECK_EQUAL(payload.getName(), payloads.front().getName());
+    BOOST_CHECK(payload.wireEncode() == payloads.front().wireEncode());
+  }
+  BOOST_REQUIRE_EQUAL(wrappedKeys.size(), 3);
+  std::set<std::vector<uint8_t>> distinctKeys;
+  for (const auto& item : wrappedKeys) {
+    distinctKeys.insert(item.second);
+  }
+  BOOST_CHECK_EQUAL(distinctKeys.size(), 3);
+
+  BLSVerifier verifier(face);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  for (size_t i = 0; i < 3; i++) {
+    verifier.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  BOOST_CHECK(verifier.verify(signedData, infoData));
+}
+
+BOOST_AUTO_TEST_CASE(SessionResumption)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // signer
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.m_ticketLifetime = time::seconds(60);
+  signer.m_ticketRequestBudget = 1;
+  signer.m_maxTickets = 1;
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_useResumption = true;
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  // schema
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  BLSVerifier verifier(face);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  verifier.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+
+  // full handshake, then a resumed request, then a full handshake once the budget is used up
+  std::vector<bool> isResumed;
+  for (int i = 0; i < 3; i++) {
+    Data unsignedData;
+    unsignedData.setName(Name("/a/b").appendNumber(i));
+    unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+    bool callbackInvoked = false;
+    Data signedData, infoData;
+    face.sentInterests.clear();
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto& d1, const auto& d2) {
+                               callbackInvoked = true;
+                               signedData = d1;
+                               infoData = d2;
+                             },
+                             [](const auto& reason) {
+                               BOOST_CHECK(false);
+                             });
+    advanceClocks(time::milliseconds(100), 11);
+    BOOST_CHECK(callbackInvoked);
+    BOOST_CHECK(verifier.verify(signedData, infoData));
+    for (const auto& interest : face.sentInterests) {
+      if (Name("/signer/mps/sign").isPrefixOf(interest.getName())) {
+        const auto& params = interest.getApplicationParameters();
+        params.parse();
+        isResumed.push_back(params.find(tlv::TicketId) != params.elements_end());
+      }
+    }
+  }
+  BOOST_CHECK(isResumed == std::vector<bool>({false, true, false}));
+  // the used-up ticket is dropped for the new one
+  BOOST_CHECK_EQUAL(signer.getTicketCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ThresholdSigners)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // 2-of-3 group key, with one key share per signer
+  BLSPublicKey groupKey;
+  std::vector<BLSSecretKey> shares;
+  std::tie(groupKey, shares) = ndnBLSDealKeyShares(2, 3);
+  std::vector<std::unique_ptr<BLSSigner>> signers;
+  ThresholdGroup group;
+  group.m_groupKeyName = Name("/group/KEY/1");
+  group.m_threshold = 2;
+  for (size_t i = 0; i < 3; i++) {
+    std::string prefix = "/signer" + std::to_string(i + 1);
+    signers.emplace_back(std::make_unique<BLSSigner>(Name(prefix), face, m_keyChain, Name(prefix + "/KEY/123")));
+    signers.back()->setSecretKey(shares[i]);
+    group.m_shareIds.emplace(signers.back()->getPublicKeyName(), i + 1);
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  for (size_t i = 0; i < 3; i++) {
+    initiator.m_schemaContainer.m_trustedIds.emplace(signers[i]->getPublicKeyName(), signers[i]->getPublicKey());
+  }
+  advanceClocks(time::milliseconds(20), 10);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  bool callbackInvoked = false;
+  Data signedData;
+  initiator.thresholdSign(unsignedData, group, initiatorId.getDefaultKey().getName(),
+                          [&](const auto& d1, const auto& d2) {
+                            callbackInvoked = true;
+                            signedData = d1;
+                          },
+                          [](const auto& reason) {
+                            std::cout << reason << std::endl;
+                            BOOST_CHECK(false);
+                          });
+  advanceClocks(time::milliseconds(200), 10);
+  BOOST_CHECK(callbackInvoked);
+  BOOST_CHECK_EQUAL(signedData.getSignatureInfo().getKeyLocator().getName(), group.m_groupKeyName);
+
+  // the verifier only knows the group key
+  BLSVerifier verifier(face);
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(group.m_groupKeyName);
+  verifier.m_schemaContainer.m_schemas.push_back(schema);
+  BOOST_CHECK(!verifier.verify(signedData));
+  verifier.m_schemaContainer.m_trustedIds.emplace(group.m_groupKeyName, groupKey);
+  BOOST_CHECK(verifier.verify(signedData));
 }
 
 BOOST_AUTO_TEST_CASE(SignerReplacement)
@@ -198,6 +431,360 @@ BOOST_AUTO_TEST_CASE(SignerReplacement)
   BOOST_CHECK(verifier.verify(signedData, infoData));
   }
 
+BOOST_AUTO_TEST_CASE(SessionDeadline)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+  util::DummyClientFace anotherFace(io, m_keyChain, { true, true });
+
+  // an unreachable signer, and a signer that rejects every request
+  BLSSigner unreachableSigner(Name("/signer1"), anotherFace, m_keyChain, Name("/signer1/KEY/123"));
+  BLSSigner rejectingSigner(Name("/signer2"), face, m_keyChain, Name("/signer2/KEY/123"),
+                            [](auto) { return true; }, [](auto) { return false; });
+  BLSSigner anotherRejectingSigner(Name("/signer3"), face, m_keyChain, Name("/signer3/KEY/123"),
+                                   [](auto) { return true; }, [](auto) { return false; });
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(unreachableSigner.getPublicKeyName(),
+                                                   unreachableSigner.getPublicKey());
+  initiator.m_schemaContainer.m_trustedIds.emplace(rejectingSigner.getPublicKeyName(),
+                                                   rejectingSigner.getPublicKey());
+  initiator.m_schemaContainer.m_trustedIds.emplace(anotherRejectingSigner.getPublicKeyName(),
+                                                   anotherRejectingSigner.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  // the session fails at its deadline, before the sign request times out
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(unreachableSigner.getPublicKeyName());
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+  size_t failureCount = 0;
+  std::string failureReason;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) {
+                             BOOST_CHECK(false);
+                           },
+                           [&](const auto& reason) {
+                             failureCount++;
+                             failureReason = reason;
+                           },
+                           time::seconds(1));
+  advanceClocks(time::milliseconds(100), 9);
+  BOOST_CHECK_EQUAL(failureCount, 0);
+  advanceClocks(time::milliseconds(100), 2);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+  BOOST_CHECK(failureReason.find("deadline") != std::string::npos);
+  // nothing of the session is left to call back or send Interests
+  face.sentInterests.clear();
+  advanceClocks(time::milliseconds(500), 20);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+  BOOST_CHECK(face.sentInterests.empty());
+
+  // a rejected request makes the signer unavailable right away
+  MultipartySchema rejectingSchema;
+  rejectingSchema.m_pktName = WildCardName("/a/b/*");
+  rejectingSchema.m_ruleId = "02";
+  rejectingSchema.m_signers.emplace_back(rejectingSigner.getPublicKeyName());
+  initiator.m_schemaContainer.m_schemas.push_back(rejectingSchema);
+  failureCount = 0;
+  initiator.multiPartySign(unsignedData, rejectingSchema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) {
+                             BOOST_CHECK(false);
+                           },
+                           [&](const auto& reason) {
+                             failureCount++;
+                             failureReason = reason;
+                           });
+  advanceClocks(time::milliseconds(100), 5);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+  BOOST_CHECK(failureReason.find("rejected") != std::string::npos);
+  // the rejection costs the signer no BLS signature
+  auto rejection = std::find_if(face.sentData.begin(), face.sentData.end(), [](const Data& data) {
+    return Name("/signer2/mps/sign").isPrefixOf(data.getName());
+  });
+  BOOST_REQUIRE(rejection != face.sentData.end());
+  BOOST_CHECK_EQUAL(rejection->getSignatureType(), ndn::tlv::DigestSha256);
+
+  // signers unavailable in the same batch are all reported
+  MultipartySchema twoRejectingSchema;
+  twoRejectingSchema.m_pktName = WildCardName("/a/b/*");
+  twoRejectingSchema.m_ruleId = "03";
+  twoRejectingSchema.m_signers.emplace_back(rejectingSigner.getPublicKeyName());
+  twoRejectingSchema.m_signers.emplace_back(anotherRejectingSigner.getPublicKeyName());
+  initiator.m_schemaContainer.m_schemas.push_back(twoRejectingSchema);
+  failureCount = 0;
+  initiator.multiPartySign(unsignedData, twoRejectingSchema, initiatorId.getDefaultKey().getName(),
+                           [](const auto&, const auto&) {
+                             BOOST_CHECK(false);
+                           },
+                           [&](const auto& reason) {
+                             failureCount++;
+                             failureReason = reason;
+                           });
+  advanceClocks(time::milliseconds(100), 5);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+  BOOST_CHECK(failureReason.find("/signer2") != std::string::npos);
+  BOOST_CHECK(failureReason.find("/signer3") != std::string::npos);
+
+  // a schema that the known signers cannot satisfy fails the session once, without throwing
+  MultipartySchema unsatisfiableSchema;
+  unsatisfiableSchema.m_pktName = WildCardName("/a/b/*");
+  unsatisfiableSchema.m_ruleId = "04";
+  unsatisfiableSchema.m_signers.emplace_back(Name("/unknown/KEY/123"));
+  failureCount = 0;
+  BOOST_CHECK_NO_THROW(initiator.multiPartySign(unsignedData, unsatisfiableSchema,
+                                                initiatorId.getDefaultKey().getName(),
+                                                [](const auto&, const auto&) {
+                                                  BOOST_CHECK(false);
+                                                },
+                                                [&](const auto& reason) {
+                                                  failureCount++;
+                                                  failureReason = reason;
+                                                }));
+  BOOST_CHECK_EQUAL(failureCount, 1);
+  BOOST_CHECK(failureReason.find("sufficient keys") != std::string::npos);
+  advanceClocks(time::milliseconds(100), 20);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+}
+
+BOOST_AUTO_TEST_CASE(SignerRequestLimits)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // signer
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  signer.m_maxRequests = 1;
+  signer.m_requestLifetime = time::seconds(3);
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  // schema
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  // the second concurrent request is turned away, and the first is dropped once its result is delivered
+  size_t successCount = 0;
+  std::vector<std::string> failureReasons;
+  for (int i = 0; i < 2; i++) {
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto&) {
+                               successCount++;
+                             },
+                             [&](const auto& reason) {
+                               failureReasons.push_back(reason);
+                             });
+  }
+  advanceClocks(time::milliseconds(20), 5);
+  BOOST_CHECK_EQUAL(signer.getRequestCount(), 1);
+  BOOST_CHECK_GT(signer.getRequestMemory(), 0);
+  advanceClocks(time::milliseconds(100), 11);
+  BOOST_CHECK_EQUAL(successCount, 1);
+  BOOST_REQUIRE_EQUAL(failureReasons.size(), 1);
+  BOOST_CHECK(failureReasons[0].find("503") != std::string::npos);
+  BOOST_CHECK_EQUAL(signer.getRequestCount(), 0);
+  BOOST_CHECK_EQUAL(signer.getRequestMemory(), 0);
+
+  // a request whose result is never fetched expires
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) {
+                             successCount++;
+                           },
+                           [&](const auto& reason) {
+                             failureReasons.push_back(reason);
+                           },
+                           time::milliseconds(500));
+  advanceClocks(time::milliseconds(100), 10);
+  BOOST_CHECK_EQUAL(failureReasons.size(), 2);
+  BOOST_CHECK_EQUAL(signer.getRequestCount(), 1);
+  advanceClocks(time::milliseconds(100), 25);
+  BOOST_CHECK_EQUAL(signer.getRequestCount(), 0);
+  BOOST_CHECK_EQUAL(signer.getRequestMemory(), 0);
+
+  // shedding load costs no BLS signature
+  signer.m_maxRequests = 0;
+  Metrics::get().reset();
+  Metrics::setEnabled(true);
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) {
+                             successCount++;
+                           },
+                           [&](const auto& reason) {
+                             failureReasons.push_back(reason);
+                           });
+  advanceClocks(time::milliseconds(20), 5);
+  Metrics::setEnabled(false);
+  BOOST_REQUIRE_EQUAL(failureReasons.size(), 3);
+  BOOST_CHECK(failureReasons[2].find("503") != std::string::npos);
+  BOOST_CHECK_EQUAL(Metrics::get().counter("signer.overloaded_requests").get(), 1);
+  BOOST_CHECK_EQUAL(Metrics::get().counter("bls.signatures").get(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SignRequestAdmission)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // signer
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  // schema
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  size_t successCount = 0;
+  size_t failureCount = 0;
+  auto sign = [&] {
+    initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                             [&](const auto&, const auto&) { successCount++; },
+                             [&](const auto&) { failureCount++; });
+  };
+  auto countAcks = [&] {
+    return std::count_if(face.sentData.begin(), face.sentData.end(), [](const Data& data) {
+      return Name("/signer/mps/sign").isPrefixOf(data.getName());
+    });
+  };
+  sign();
+  advanceClocks(time::milliseconds(100), 11);
+  BOOST_CHECK_EQUAL(successCount, 1);
+  BOOST_CHECK_EQUAL(countAcks(), 1);
+
+  // a replayed sign request is dropped
+  Interest signRequest;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/signer/mps/sign").isPrefixOf(interest.getName())) {
+      signRequest = interest;
+    }
+  }
+  face.receive(signRequest);
+  // so is one without a timestamp and a nonce
+  Interest unsignedRequest(Name("/signer/mps/sign"));
+  unsignedRequest.setApplicationParameters(signRequest.getApplicationParameters());
+  face.receive(unsignedRequest);
+  // and a malformed one
+  Interest malformedRequest(Name("/signer/mps/sign"));
+  malformedRequest.setApplicationParameters(makeStringBlock(ndn::tlv::ApplicationParameters, "garbage"));
+  face.receive(malformedRequest);
+  advanceClocks(time::milliseconds(20), 5);
+  BOOST_CHECK_EQUAL(countAcks(), 1);
+  BOOST_CHECK_EQUAL(signer.getRequestCount(), 0);
+
+  // one request per burst, the second concurrent session is never answered
+  signer.m_requestRate = 0.01;
+  signer.m_requestBurst = 1;
+  sign();
+  sign();
+  advanceClocks(time::milliseconds(100), 11);
+  BOOST_CHECK_EQUAL(successCount, 2);
+  BOOST_CHECK_EQUAL(countAcks(), 2);
+  advanceClocks(time::milliseconds(500), 10);
+  BOOST_CHECK_EQUAL(failureCount, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TracedSession)
+{
+  util::DummyClientFace face(io, m_keyChain, { true, true });
+
+  // signer
+  BLSSigner signer(Name("/signer"), face, m_keyChain, Name("/signer/KEY/123"));
+  advanceClocks(time::milliseconds(20), 10);
+
+  // initiator
+  auto initiatorId = addIdentity("initiator");
+  Scheduler scheduler(io);
+  MPSInitiator initiator(Name("/initiator"), m_keyChain, face, scheduler);
+  initiator.m_schemaContainer.m_trustedIds.emplace(Name("/signer/KEY/123"), signer.getPublicKey());
+  advanceClocks(time::milliseconds(20), 10);
+
+  // schema
+  MultipartySchema schema;
+  schema.m_pktName = WildCardName("/a/b/*");
+  schema.m_ruleId = "01";
+  schema.m_signers.emplace_back(Name("/signer/KEY/123"));
+  initiator.m_schemaContainer.m_schemas.push_back(schema);
+
+  // data to sign
+  Data unsignedData;
+  unsignedData.setName(Name("/a/b/c"));
+  unsignedData.setContent(Name("/1/2/3/4").wireEncode());
+
+  Tracer::get().clear();
+  Tracer::setEnabled(true);
+  bool callbackInvoked = false;
+  initiator.multiPartySign(unsignedData, schema, initiatorId.getDefaultKey().getName(),
+                           [&](const auto&, const auto&) {
+                             callbackInvoked = true;
+                           },
+                           [](const auto& reason) {
+                             BOOST_CHECK(false);
+                           });
+  advanceClocks(time::milliseconds(100), 11);
+  Tracer::setEnabled(false);
+  BOOST_CHECK(callbackInvoked);
+
+  // the trace ID of the sign request is echoed in the ACK
+  uint64_t traceId = 0;
+  for (const auto& interest : face.sentInterests) {
+    if (Name("/signer/mps/sign").isPrefixOf(interest.getName())) {
+      traceId = readTraceId(interest.getApplicationParameters());
+    }
+  }
+  BOOST_CHECK_NE(traceId, 0);
+  for (const auto& data : face.sentData) {
+    if (Name("/signer/mps/sign").isPrefixOf(data.getName())) {
+      BOOST_CHECK_EQUAL(readTraceId(data.getContent()), traceId);
+    }
+  }
+
+  // both sides record their spans under the trace ID of the session
+  std::set<std::string> names;
+  for (const auto& event : Tracer::get().getEvents()) {
+    BOOST_CHECK_EQUAL(event.m_traceId, traceId);
+    names.insert(event.m_name);
+  }
+  for (const auto& name : {"session", "rpc", "handshake", "on_sign_request", "parameter_fetch", "signing"}) {
+    BOOST_CHECK_MESSAGE(names.count(name) == 1, "missing span " << name);
+  }
+  Tracer::get().clear();
+}
+
 // BOOST_AUTO_TEST_CASE(VerifierFetch)
 // {
 //   util::DummyClientFace face(io, m_keyChain, {true, true});
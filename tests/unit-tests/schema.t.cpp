@@ -190,6 +190,82 @@ BOOST_AUTO_TEST_CASE(SchemaMinSignerWithPrefix)
   BOOST_CHECK(schema.passSchema(names));
 }
 
+BOOST_AUTO_TEST_CASE(SelectionSessionReplace)
+{
+  MultipartySchemaContainer container;
+  for (const auto& keyName : {"/a/KEY/1", "/a/KEY/2", "/a/KEY/3", "/b/KEY/1", "/b/KEY/2"}) {
+    container.m_trustedIds.emplace(Name(keyName), BLSPublicKey());
+  }
+  MultipartySchema schema;
+  schema.m_pktName.m_name = Name("/a/b/c");
+  schema.m_ruleId = "...";
+  schema.m_signers.emplace_back("2x/a/KEY/*");
+  schema.m_optionalSigners.emplace_back("/b/KEY/*");
+  schema.m_minOptionalSigners = 1;
+
+  SignerSelectionSession session(container, schema);
+  auto signers = session.getSigners();
+  BOOST_CHECK_EQUAL(signers.m_signers.size(), 3);
+  BOOST_CHECK(schema.passSchema(signers.m_signers));
+
+  // replace two failed signers in one step
+  MpsSignerList newSigners;
+  std::vector<Name> diff;
+  std::tie(newSigners, diff) = session.replaceSigners({Name("/a/KEY/1"), Name("/b/KEY/1")});
+  BOOST_CHECK_EQUAL(newSigners.m_signers.size(), 3);
+  BOOST_CHECK(schema.passSchema(newSigners.m_signers));
+  BOOST_REQUIRE_EQUAL(diff.size(), 2);
+  BOOST_CHECK_EQUAL(diff[0], Name("/a/KEY/3"));
+  BOOST_CHECK_EQUAL(diff[1], Name("/b/KEY/2"));
+
+  // a signer that is not selected does not change the selection
+  std::tie(newSigners, diff) = session.replaceSigners({Name("/b/KEY/1")});
+  BOOST_CHECK_EQUAL(newSigners.m_signers.size(), 3);
+  BOOST_CHECK(diff.empty());
+
+  // no replacement left for the required pattern
+  std::tie(newSigners, diff) = session.replaceSigners({Name("/a/KEY/2")});
+  BOOST_CHECK(newSigners.m_signers.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SelectionSessionInsufficientKeys)
+{
+  MultipartySchemaContainer container;
+  container.m_trustedIds.emplace(Name("/a/KEY/1"), BLSPublicKey());
+  MultipartySchema schema;
+  schema.m_pktName.m_name = Name("/a/b/c");
+  schema.m_ruleId = "...";
+  schema.m_signers.emplace_back("2x/a/KEY/*");
+  BOOST_CHECK_THROW(SignerSelectionSession session(container, schema), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ImportCertificates)
+{
+  ndnBLSInit();
+
+  security::ValidityPeriod period(time::system_clock::now(), time::system_clock::now() + time::days(1));
+  std::vector<security::Certificate> certs;
+  for (int i = 0; i < 4; i++) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    BLSPublicKey pk;
+    blsGetPublicKey(&pk, &sk);
+    certs.push_back(genSelfSignedCertificate(Name("/signer" + std::to_string(i) + "/KEY/123"), pk, sk, period));
+  }
+  // a certificate whose public key is not owned by the signer
+  auto sigValue = certs[0].getSignatureValue();
+  certs[2].setSignatureValue(std::make_shared<Buffer>(sigValue.value(), sigValue.value_size()));
+  certs[2].wireEncode();
+
+  MultipartySchemaContainer container;
+  auto rejected = container.importCertificates(certs);
+  BOOST_REQUIRE_EQUAL(rejected.size(), 1);
+  BOOST_CHECK_EQUAL(rejected[0], certs[2].getName());
+  BOOST_CHECK_EQUAL(container.m_trustedIds.size(), 3);
+  BOOST_CHECK(container.isTrustedKey(Name("/signer0/KEY/123")));
+  BOOST_CHECK(!container.isTrustedKey(Name("/signer2/KEY/123")));
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // TestSchema
 
 }  // namespace tests
@@ -0,0 +1,100 @@
+#include "ndnmps/tracer.hpp"
+#include "test-common.hpp"
+#include <sstream>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestTracer)
+
+BOOST_AUTO_TEST_CASE(Spans)
+{
+  auto& tracer = Tracer::get();
+  tracer.clear();
+
+  // disabled tracing records nothing and gives no trace ID
+  BOOST_CHECK_EQUAL(Tracer::newTraceId(), 0);
+  {
+    TraceSpan span("disabled", 1, "track");
+    BOOST_CHECK(!span.isActive());
+  }
+  tracer.addInstantEvent("disabled", 1, "track");
+  BOOST_CHECK(tracer.getEvents().empty());
+
+  Tracer::setEnabled(true);
+  auto traceId = Tracer::newTraceId();
+  BOOST_CHECK_NE(traceId, 0);
+  {
+    TraceSpan untraced("untraced", 0, "track");
+    BOOST_CHECK(!untraced.isActive());
+
+    TraceSpan span("explicit", traceId, "track");
+    BOOST_CHECK(span.isActive());
+    span.end({{"status", "ok"}});
+    BOOST_CHECK(!span.isActive());
+    span.end();
+
+    TraceSpan moved("moved", traceId, "track");
+    TraceSpan target(std::move(moved));
+    BOOST_CHECK(!moved.isActive());
+    BOOST_CHECK(target.isActive());
+  }
+  tracer.addInstantEvent("instant", traceId, "track");
+  Tracer::setEnabled(false);
+
+  // the moved span ends once, when its new owner is destroyed
+  auto events = tracer.getEvents();
+  BOOST_REQUIRE_EQUAL(events.size(), 3);
+  BOOST_CHECK_EQUAL(events[0].m_name, "explicit");
+  BOOST_CHECK_EQUAL(events[0].m_phase, 'X');
+  BOOST_CHECK_EQUAL(events[0].m_args.at("status"), "ok");
+  BOOST_CHECK_EQUAL(events[1].m_name, "moved");
+  BOOST_CHECK_EQUAL(events[2].m_name, "instant");
+  BOOST_CHECK_EQUAL(events[2].m_phase, 'i');
+  for (const auto& event : events) {
+    BOOST_CHECK_EQUAL(event.m_traceId, traceId);
+    BOOST_CHECK_GE(event.m_duration, 0);
+  }
+  tracer.clear();
+}
+
+BOOST_AUTO_TEST_CASE(ChromeTrace)
+{
+  auto& tracer = Tracer::get();
+  tracer.clear();
+  Tracer::setEnabled(true);
+  auto begin = std::chrono::steady_clock::now();
+  tracer.addCompleteEvent("rpc", 0x1234, "initiator /a", begin, begin + std::chrono::microseconds(1500),
+                          {{"reason", "a \"quoted\"\nreason"}});
+  tracer.addInstantEvent("result", 0x1234, "signer /b");
+  Tracer::setEnabled(false);
+
+  std::ostringstream os;
+  tracer.writeChromeTrace(os);
+  auto json = os.str();
+  BOOST_CHECK(json.find("\"args\": {\"name\": \"session 1234\"}") != std::string::npos);
+  BOOST_CHECK(json.find("\"args\": {\"name\": \"initiator /a\"}") != std::string::npos);
+  BOOST_CHECK(json.find("\"args\": {\"name\": \"signer /b\"}") != std::string::npos);
+  BOOST_CHECK(json.find("\"ph\": \"X\"") != std::string::npos);
+  BOOST_CHECK(json.find("\"dur\": 1500") != std::string::npos);
+  BOOST_CHECK(json.find("\"ph\": \"i\", \"ts\"") != std::string::npos);
+  BOOST_CHECK(json.find("\"reason\": \"a \\\"quoted\\\"\\nreason\"") != std::string::npos);
+  tracer.clear();
+}
+
+BOOST_AUTO_TEST_CASE(ReadTraceId)
+{
+  Block block(ndn::tlv::Content);
+  BOOST_CHECK_EQUAL(readTraceId(block), 0);
+  block.push_back(makeNonNegativeIntegerBlock(tlv::TraceId, 42));
+  block.encode();
+  BOOST_CHECK_EQUAL(readTraceId(block), 42);
+  BOOST_CHECK_EQUAL(readTraceId(Block()), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTracer
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn
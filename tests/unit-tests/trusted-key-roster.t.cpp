@@ -0,0 +1,221 @@
+#include "ndnmps/schema.hpp"
+#include "ndnmps/trusted-key-roster.hpp"
+#include "test-common.hpp"
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+namespace ndn {
+namespace mps {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(TestTrustedKeyRoster)
+
+BOOST_AUTO_TEST_CASE(WriteAndLoad)
+{
+  ndnBLSInit();
+
+  std::vector<TrustedKeyRoster::Entry> entries;
+  std::vector<BLSSecretKey> sks;
+  for (const auto& keyName : {"/c/KEY/1", "/a/KEY/1", "/b/KEY/1"}) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    TrustedKeyRoster::Entry entry;
+    entry.m_keyName = Name(keyName);
+    blsGetPublicKey(&entry.m_publicKey, &sk);
+    blsGetPop(&entry.m_proofOfPossession, &sk);
+    entries.push_back(entry);
+    sks.push_back(sk);
+  }
+  std::string fileName = std::string(TMP_TESTS_PATH) + "/roster.bin";
+  TrustedKeyRoster::writeRoster(fileName, entries, 7);
+
+  TrustedKeyRoster roster(fileName);
+  BOOST_CHECK_EQUAL(roster.size(), 3);
+  BOOST_CHECK_EQUAL(roster.getVersion(), 7);
+  BOOST_CHECK_EQUAL(roster.getKeyNames()[0], Name("/a/KEY/1"));
+  BOOST_CHECK_EQUAL(roster.find(Name("/d/KEY/1")), TrustedKeyRoster::npos);
+  for (const auto& entry : entries) {
+    auto index = roster.find(entry.m_keyName);
+    BOOST_REQUIRE_NE(index, TrustedKeyRoster::npos);
+    BOOST_CHECK(blsPublicKeyIsEqual(&roster.getPublicKey(index), &entry.m_publicKey));
+    auto pop = roster.getProofOfPossession(index);
+    BOOST_CHECK(blsVerifyPop(&pop, &roster.getPublicKey(index)));
+  }
+
+  // the keys of a shared roster are decoded once, whichever thread gets them first
+  TrustedKeyRoster sharedRoster(fileName);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&sharedRoster] {
+      for (size_t index = 0; index < sharedRoster.size(); index++) {
+        sharedRoster.getPublicKey(index);
+      }
+      sharedRoster.getDigest();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK(blsPublicKeyIsEqual(&sharedRoster.getPublicKey(sharedRoster.find(entries[0].m_keyName)),
+                                  &entries[0].m_publicKey));
+  BOOST_CHECK(sharedRoster.getDigest() == roster.getDigest());
+
+  // the container resolves keys from both m_trustedIds and the roster
+  MultipartySchemaContainer container;
+  container.loadTrustedIds(fileName);
+  BOOST_CHECK(container.isTrustedKey(Name("/b/KEY/1")));
+  BOOST_CHECK(!container.isTrustedKey(Name("/d/KEY/1")));
+  BOOST_CHECK_THROW(container.getTrustedKey(Name("/d/KEY/1")), std::runtime_error);
+  // and by the encoded names
+  BOOST_CHECK_EQUAL(roster.find(Name("/c/KEY/1").wireEncode()), roster.find(Name("/c/KEY/1")));
+  BOOST_CHECK_EQUAL(roster.find(Name("/d/KEY/1").wireEncode()), TrustedKeyRoster::npos);
+  container.m_trustedIds.emplace(Name("/e/KEY/1"), entries[0].m_publicKey);
+  BOOST_CHECK(container.isTrustedKey(Name("/b/KEY/1").wireEncode()));
+  BOOST_CHECK(container.isTrustedKey(Name("/e/KEY/1").wireEncode()));
+  BOOST_CHECK(!container.isTrustedKey(Name("/d/KEY/1").wireEncode()));
+  BOOST_CHECK(blsPublicKeyIsEqual(&container.getTrustedKey(Name("/e/KEY/1").wireEncode()), &entries[0].m_publicKey));
+  BOOST_CHECK_THROW(container.getTrustedKey(Name("/d/KEY/1").wireEncode()), std::runtime_error);
+  container.m_trustedIds.erase(Name("/e/KEY/1"));
+
+  Data data;
+  data.setName(Name("/a/b/c/d"));
+  data.setContent(Name("/1/2/3/4").wireEncode());
+  SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(tlv::SignatureSha256WithBls), Name("/signer/KEY/123"));
+  std::vector<Buffer> sigs;
+  for (const auto& sk : sks) {
+    sigs.emplace_back(ndnGenBLSSignature(sk, data, info));
+  }
+  data.setSignatureInfo(info);
+  data.setSignatureValue(std::make_shared<Buffer>(ndnBLSAggregateSignature(sigs)));
+  data.wireEncode();
+  MpsSignerList signers(std::vector<Name>{"/a/KEY/1", "/b/KEY/1", "/c/KEY/1"});
+  BOOST_CHECK(ndnBLSVerify(container.aggregateKey(signers), data));
+
+  // a key without a valid proof of possession, e.g. a rogue key, is caught on load
+  BOOST_CHECK(roster.findInvalidProofsOfPossession().empty());
+  entries[0].m_proofOfPossession = entries[1].m_proofOfPossession;
+  TrustedKeyRoster::writeRoster(fileName + ".rogue", entries, 8);
+  TrustedKeyRoster rogueRoster(fileName + ".rogue");
+  auto invalidIndexes = rogueRoster.findInvalidProofsOfPossession();
+  std::vector<size_t> expectedIndexes{rogueRoster.find(Name("/c/KEY/1"))};
+  BOOST_CHECK_EQUAL_COLLECTIONS(invalidIndexes.begin(), invalidIndexes.end(),
+                                expectedIndexes.begin(), expectedIndexes.end());
+  MultipartySchemaContainer rogueContainer;
+  BOOST_CHECK_THROW(rogueContainer.loadTrustedIds(fileName + ".rogue"), std::runtime_error);
+  BOOST_CHECK(rogueContainer.m_roster == nullptr);
+  rogueContainer.loadTrustedIds(fileName + ".rogue", false);
+  BOOST_CHECK(rogueContainer.isTrustedKey(Name("/c/KEY/1")));
+}
+
+BOOST_AUTO_TEST_CASE(SignerListEncoding)
+{
+  ndnBLSInit();
+
+  std::vector<TrustedKeyRoster::Entry> entries;
+  for (int i = 0; i < 64; i++) {
+    BLSSecretKey sk;
+    blsSecretKeySetByCSPRNG(&sk);
+    TrustedKeyRoster::Entry entry;
+    entry.m_keyName = Name("/org/unit" + std::to_string(i) + "/KEY/123/456");
+    blsGetPublicKey(&entry.m_publicKey, &sk);
+    blsGetPop(&entry.m_proofOfPossession, &sk);
+    entries.push_back(entry);
+  }
+  std::string fileName = std::string(TMP_TESTS_PATH) + "/roster-64.bin";
+  TrustedKeyRoster::writeRoster(fileName, entries, 1);
+  TrustedKeyRoster roster(fileName);
+  BOOST_CHECK_EQUAL(roster.getDigest().size(), 32);
+
+  // dense list: bitmap
+  std::vector<Name> denseNames;
+  std::vector<BLSPublicKey> densePks;
+  for (size_t i = 0; i < entries.size(); i += 2) {
+    denseNames.push_back(entries[i].m_keyName);
+    densePks.push_back(entries[i].m_publicKey);
+  }
+  MpsSignerList dense(denseNames);
+  auto denseWire = roster.encodeSignerList(dense);
+  denseWire.parse();
+  BOOST_CHECK(denseWire.find(tlv::SignerBitmap) != denseWire.elements_end());
+  BOOST_CHECK_LT(denseWire.size(), dense.wireEncode().size());
+  auto decodedDense = roster.decodeSignerList(denseWire);
+  BOOST_CHECK(decodedDense == dense);
+  auto aggKey = roster.aggregateKey(roster.decodeSignerIndexes(denseWire));
+  auto expectedKey = ndnBLSAggregatePublicKey(densePks);
+  BOOST_CHECK(blsPublicKeyIsEqual(&aggKey, &expectedKey));
+
+  // sparse list: delta-coded indexes
+  MpsSignerList sparse(std::vector<Name>{entries[3].m_keyName, entries[60].m_keyName});
+  auto sparseWire = roster.encodeSignerList(sparse);
+  sparseWire.parse();
+  BOOST_CHECK(sparseWire.find(tlv::SignerIndexDeltas) != sparseWire.elements_end());
+  BOOST_CHECK(roster.decodeSignerList(sparseWire) == sparse);
+
+  // unknown signer
+  MpsSignerList unknown(std::vector<Name>{Name("/org/unknown/KEY/123/456")});
+  BOOST_CHECK_THROW(roster.encodeSignerList(unknown), std::runtime_error);
+
+  // list of another roster
+  TrustedKeyRoster::writeRoster(fileName + ".2", entries, 2);
+  TrustedKeyRoster anotherRoster(fileName + ".2");
+  BOOST_CHECK_THROW(anotherRoster.decodeSignerIndexes(sparseWire), ndn::tlv::Error);
+
+  // forged lists with indexes out of the roster range
+  auto makeForgedList = [&](uint32_t type, const std::vector<uint64_t>& values, bool isVarNumber) {
+    std::ostringstream os;
+    for (auto value : values) {
+      if (isVarNumber) {
+        ndn::tlv::writeVarNumber(os, value);
+      }
+      else {
+        os.put(static_cast<char>(value));
+      }
+    }
+    auto value = os.str();
+    Block wire(tlv::MpsRosterSignerList);
+    wire.push_back(makeNonNegativeIntegerBlock(tlv::RosterVersion, 1));
+    wire.push_back(makeBinaryBlock(tlv::RosterDigest, roster.getDigest().data(), roster.getDigest().size()));
+    wire.push_back(makeBinaryBlock(type, reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+    wire.encode();
+    return wire;
+  };
+  // the second delta wraps the sum around to 2
+  auto wrapped = makeForgedList(tlv::SignerIndexDeltas, {1000000000, std::numeric_limits<uint64_t>::max() - 999999997}, true);
+  BOOST_CHECK_THROW(roster.decodeSignerIndexes(wrapped), ndn::tlv::Error);
+  BOOST_CHECK_THROW(roster.decodeSignerList(wrapped), ndn::tlv::Error);
+  BOOST_CHECK_THROW(roster.decodeSignerIndexes(makeForgedList(tlv::SignerIndexDeltas, {64}, true)), ndn::tlv::Error);
+  BOOST_CHECK_THROW(roster.decodeSignerIndexes(makeForgedList(tlv::SignerIndexDeltas, {60, 4}, true)), ndn::tlv::Error);
+  BOOST_CHECK_EQUAL(roster.decodeSignerIndexes(makeForgedList(tlv::SignerIndexDeltas, {60, 3}, true)).back(), 63);
+  BOOST_CHECK_THROW(roster.decodeSignerIndexes(makeForgedList(tlv::SignerBitmap, {0, 0, 0, 0, 0, 0, 0, 0, 0x80}, false)),
+                    ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_CASE(LoadFail)
+{
+  BOOST_CHECK_THROW(TrustedKeyRoster("nonexistent-roster.bin"), std::runtime_error);
+
+  std::string fileName = std::string(TMP_TESTS_PATH) + "/bad-roster.bin";
+  {
+    std::ofstream os(fileName, std::ios::binary);
+    os << "NOTAROSTERFILE..........";
+  }
+  MultipartySchemaContainer container;
+  BOOST_CHECK_THROW(container.loadTrustedIds(fileName), std::runtime_error);
+
+  // a record count far beyond the file size
+  {
+    std::ofstream os(fileName, std::ios::binary | std::ios::trunc);
+    os << "NDNMPSRS";
+    os.write("\x00\x00\x00\x01\xff\xff\xff\xff", 8);
+    os.write("\x00\x00\x00\x00\x00\x00\x00\x00", 8);
+  }
+  BOOST_CHECK_THROW(TrustedKeyRoster{fileName}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTrustedKeyRoster
+
+}  // namespace tests
+}  // namespace mps
+}  // namespace ndn